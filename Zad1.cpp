@@ -3,125 +3,5358 @@
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
+#include <complex>
+#include <algorithm>
+#include <limits>
+#include <chrono>
+#include <mutex>
+#include <span>
+#include <queue>
+#include <tuple>
+#include <array>
+#include <utility>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <ranges>
+#include <optional>
+#include <charconv>
+#include <string_view>
+#include <fstream>
+#include <bit>
+#include <cstring>
+#include <cstdint>
+#include <numeric>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define WIELOMIAN_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WIELOMIAN_MMAP 1    // PolynomialStore mapuje plik do pamięci; bez tego wczytuje go w całości
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 /**
- * Klasa reprezentująca wielomian.
- * Przechowuje współczynniki i udostępnia operacje takie jak dodawanie, odejmowanie, mnożenie, ewaluacja i reprezentacja tekstowa.
+ * Progi przełączania algorytmów mnożenia wielomianów.
+ * Wartości to liczba współczynników krótszego czynnika; można je stroić w czasie działania programu.
+ * Progi Karatsuby i FFT są kalibrowane samoczynnie, raz, przy pierwszym mnożeniu, w którym wybór algorytmu ma
+ * znaczenie (ok. 15 ms). Progi są atomowe, bo czytają je wątki pul (productOf, sumOf, pierwiastki); zmiana
+ * w trakcie mnożenia wpływa tylko na wybór algorytmu, nie na wynik (dla double — co najwyżej na ostatnich bitach).
+ */
+struct ProgiMnozenia {
+    static inline atomic<size_t> karatsuba{ 32 };  // od tej długości krótszego czynnika mnożymy algorytmem Karatsuby
+    static inline atomic<size_t> fft{ 128 };       // od tej długości krótszego czynnika mnożymy przez FFT
+    static inline atomic<size_t> ntt{ 64 };        // od tej długości krótszego czynnika mnożymy nad GF(p) przez NTT
+    static inline atomic<size_t> newton{ 64 };     // od tej długości dzielnika i ilorazu dzielimy przez odwrotność Newtona
+    static inline atomic<bool> automatycznie{ true };  // false zachowuje progi ustawione ręcznie (albo domyślne) bez kalibracji
+
+    /**
+     * Mierzy czas mnożenia szkolnego, Karatsuby i FFT na tej maszynie i ustawia oba progi.
+     * Można ją wywołać jawnie (np. na początku programu); wtedy kalibracja przy pierwszym mnożeniu jest pomijana.
+     */
+    static void kalibruj();
+
+    /**
+     * Kalibruje progi dokładnie raz, o ile nie zrobiono tego wcześniej i automatycznie == true. Wywołuje ją
+     * detail::mnoz; call_once sprawia, że wątki pul czekają na jeden pomiar zamiast mierzyć równolegle.
+     */
+    static void kalibrujRaz() {
+        static once_flag flaga;
+        if (!skalibrowane.load(memory_order_acquire) && automatycznie.load(memory_order_relaxed))
+            call_once(flaga, [] { if (!skalibrowane.load(memory_order_acquire)) kalibruj(); });
+    }
+
+private:
+    static inline atomic<bool> skalibrowane{ false };
+};
+
+/**
+ * Czy T jest typem std::complex.
+ */
+template <class T>
+struct jestZespolony : false_type {};
+
+template <class T>
+struct jestZespolony<complex<T>> : true_type {};
+
+/**
+ * Współczynniki przybliżone (zmiennoprzecinkowe, także zespolone): wyniki obarczone są błędem zaokrągleń,
+ * który algorytmy muszą kontrolować. Typy całkowite i LiczbaModulo liczone są dokładnie.
+ */
+template <class T>
+concept WspolczynnikPrzyblizony = is_floating_point_v<T> || jestZespolony<T>::value;
+
+namespace detail {
+    /**
+     * Mnożenie szkolne O(n*m). Dopisuje iloczyn do bufora wynik o długości n + m - 1.
+     */
+    template <class T>
+    void mnozNaiwnie(const T* a, size_t n, const T* b, size_t m, T* wynik) {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < m; ++j)
+                wynik[i + j] += a[i] * b[j];
+    }
+
+    /**
+     * Zwraca tablicę pierwiastków z jedności dla FFT długości n.
+     * Element [k + j] (k potęga dwójki, j < k) to exp(i*pi*j/k). Tablica rośnie leniwie i jest osobna dla każdego wątku.
+     */
+    inline const vector<complex<double>>& korzenieFFT(size_t n) {
+        static thread_local vector<complex<double>> rt(2, complex<double>(1, 0));
+        for (size_t k = rt.size(); k < n; k *= 2) {
+            rt.resize(2 * k);
+            for (size_t j = 0; j < k; ++j) {
+                long double kat = acosl(-1.0L) * j / k;     // liczone bezpośrednio, żeby błąd się nie kumulował
+                rt[k + j] = complex<double>((double)cosl(kat), (double)sinl(kat));
+            }
+        }
+        return rt;
+    }
+
+    /**
+     * Iteracyjna, niezbiorcza FFT radix-2 w miejscu. Długość a musi być potęgą dwójki.
+     * Transformata jest nieznormalizowana, z jądrem exp(+2*pi*i*jk/n).
+     */
+    inline void fft(vector<complex<double>>& a) {
+        size_t n = a.size();
+        if (n <= 1) return;
+        const vector<complex<double>>& rt = korzenieFFT(n);
+
+        for (size_t i = 1, j = 0; i < n; ++i) {    // permutacja odwracająca bity
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) swap(a[i], a[j]);
+        }
+
+        for (size_t k = 1; k < n; k *= 2)
+            for (size_t i = 0; i < n; i += 2 * k)
+                for (size_t j = 0; j < k; ++j) {
+                    // mnożenie zespolone rozpisane ręcznie, bez sprawdzania NaN/inf z operatora biblioteki
+                    const complex<double>& w = rt[k + j];
+                    complex<double>& u = a[i + j];
+                    complex<double>& v = a[i + j + k];
+                    double re = w.real() * v.real() - w.imag() * v.imag();
+                    double im = w.real() * v.imag() + w.imag() * v.real();
+                    v = complex<double>(u.real() - re, u.imag() - im);
+                    u = complex<double>(u.real() + re, u.imag() + im);
+                }
+    }
+
+    /**
+     * Splot cykliczny długości N (potęga dwójki, N >= n, m) dla danych rzeczywistych: współczynnik i iloczynu trafia na i mod N.
+     * Oba czynniki pakujemy do jednego wektora zespolonego (a w części rzeczywistej, b w urojonej),
+     * uzupełniamy zerami do N i liczymy tylko dwie transformaty zamiast trzech.
+     */
+    inline vector<double> splotCyklicznyFFT(const double* a, size_t n, const double* b, size_t m, size_t N) {
+        vector<complex<double>> z(N);
+        for (size_t i = 0; i < n; ++i) z[i].real(a[i]);
+        for (size_t i = 0; i < m; ++i) z[i].imag(b[i]);
+        fft(z);
+
+        // Z[k] = A[k] + iB[k], więc A[k]B[k] = (Z[k]^2 - conj(Z[-k])^2) / 4i.
+        // Wynik od razu sprzęgamy, żeby transformata odwrotna była zwykłą transformatą w przód.
+        vector<complex<double>> p(N);
+        for (size_t k = 0; k < N; ++k) {
+            complex<double> x = z[k], y = conj(z[(N - k) & (N - 1)]);
+            complex<double> r = (x * x - y * y) * complex<double>(0, -0.25);
+            p[k] = conj(r);
+        }
+        fft(p);
+
+        vector<double> wynik(N);
+        for (size_t i = 0; i < N; ++i) wynik[i] = p[i].real() / N;
+        return wynik;
+    }
+
+    /**
+     * Iloczyn przez FFT: splot cykliczny o długości potęgi dwójki >= n + m - 1, więc bez zawijania.
+     */
+    inline vector<double> mnozFFT(const double* a, size_t n, const double* b, size_t m) {
+        size_t dl = n + m - 1, N = 1;
+        while (N < dl) N *= 2;
+        vector<double> wynik = splotCyklicznyFFT(a, n, b, m, N);
+        wynik.resize(dl);
+        return wynik;
+    }
+
+    /**
+     * Iloczyn przez FFT dla współczynników zespolonych: trzy transformaty, odwrotną liczymy jako sprzężenie transformaty sprzężenia.
+     */
+    inline vector<complex<double>> mnozFFTZespolone(const complex<double>* a, size_t n, const complex<double>* b, size_t m) {
+        size_t dl = n + m - 1, N = 1;
+        while (N < dl) N *= 2;
+        vector<complex<double>> fa(N), fb(N);
+        copy(a, a + n, fa.begin());
+        copy(b, b + m, fb.begin());
+        fft(fa);
+        fft(fb);
+        for (size_t k = 0; k < N; ++k) fa[k] = conj(fa[k] * fb[k]);
+        fft(fa);
+
+        vector<complex<double>> wynik(dl);
+        for (size_t i = 0; i < dl; ++i) wynik[i] = conj(fa[i]) / double(N);
+        return wynik;
+    }
+
+    /**
+     * Rozmiar bufora roboczego potrzebnego karatsubaRek dla czynników długości n.
+     */
+    inline size_t buforKaratsuby(size_t n, size_t prog) {
+        size_t rozmiar = 0;
+        while (n >= prog && n > 1) {
+            size_t k = n - n / 2;
+            rozmiar += 4 * k;
+            n = k;
+        }
+        return rozmiar;
+    }
+
+    /**
+     * Rekurencyjny Karatsuba dla dwóch czynników tej samej długości n.
+     * Zapisuje iloczyn (2n - 1 współczynników) do wynik, a wszystkie wartości pośrednie trzyma w bufor,
+     * przygotowanym wcześniej na rozmiar buforKaratsuby(n, prog) — rekurencja niczego nie alokuje.
+     */
+    template <class T>
+    void karatsubaRek(const T* a, const T* b, size_t n, T* wynik, T* bufor, size_t prog) {
+        if (n < prog || n <= 1) {
+            fill(wynik, wynik + 2 * n - 1, T(0));
+            mnozNaiwnie(a, n, b, n, wynik);
+            return;
+        }
+
+        size_t h = n / 2, k = n - h;   // a = a0 + x^h * a1, gdzie a0 ma h, a a1 ma k >= h współczynników
+        T* sa = bufor;
+        T* sb = bufor + k;
+        T* z1 = bufor + 2 * k;    // 2k - 1 współczynników, jedno miejsce zapasu
+        T* glebiej = bufor + 4 * k;
+
+        karatsubaRek(a, b, h, wynik, glebiej, prog);                    // z0 -> wynik[0, 2h - 1)
+        wynik[2 * h - 1] = T(0);
+        karatsubaRek(a + h, b + h, k, wynik + 2 * h, glebiej, prog);    // z2 -> wynik[2h, 2n - 1)
+
+        for (size_t i = 0; i < k; ++i) {
+            sa[i] = i < h ? a[h + i] + a[i] : a[h + i];
+            sb[i] = i < h ? b[h + i] + b[i] : b[h + i];
+        }
+        karatsubaRek(sa, sb, k, z1, glebiej, prog);                     // (a0 + a1)(b0 + b1)
+
+        for (size_t i = 0; i < 2 * h - 1; ++i) z1[i] -= wynik[i];
+        for (size_t i = 0; i < 2 * k - 1; ++i) z1[i] -= wynik[2 * h + i];
+        for (size_t i = 0; i < 2 * k - 1; ++i) wynik[h + i] += z1[i];
+    }
+
+    /**
+     * Mnożenie Karatsuby dla czynników dowolnej długości.
+     * Dłuższy czynnik jest cięty na kawałki długości krótszego; cały bufor roboczy alokujemy raz.
+     */
+    template <class T>
+    vector<T> mnozKaratsuba(const T* a, size_t n, const T* b, size_t m, size_t prog) {
+        if (n < m) { swap(a, b); swap(n, m); }
+
+        vector<T> wynik(n + m - 1, T(0));
+        vector<T> bufor(m + (2 * m - 1) + buforKaratsuby(m, prog));
+        T* kawalek = bufor.data();
+        T* iloczyn = kawalek + m;
+        T* roboczy = iloczyn + 2 * m - 1;
+
+        for (size_t p = 0; p < n; p += m) {
+            size_t dl = min(m, n - p);
+            copy(a + p, a + p + dl, kawalek);
+            fill(kawalek + dl, kawalek + m, T(0));   // ostatni kawałek uzupełniamy zerami
+            karatsubaRek(kawalek, b, m, iloczyn, roboczy, prog);
+            for (size_t i = 0; i < min(2 * m - 1, wynik.size() - p); ++i)
+                wynik[p + i] += iloczyn[i];
+        }
+        return wynik;
+    }
+
+    /**
+     * Oszacowanie maksymalnego błędu bezwzględnego współczynnika iloczynu liczonego przez mnozFFT
+     * względem dokładnego wyniku: 5 * eps * log2(N) * ||a||_2 * ||b||_2, gdzie N to długość transformaty.
+     * Mnożenie szkolne ma błąd rzędu eps * min(n, m) * max|a| * max|b|, więc oba wyniki zgadzają się z dokładnością do sumy tych ograniczeń.
+     */
+    inline double ograniczenieBleduFFT(const double* a, size_t n, const double* b, size_t m) {
+        size_t N = 1, logN = 0;
+        while (N < n + m - 1) { N *= 2; ++logN; }
+        double na = 0, nb = 0;
+        for (size_t i = 0; i < n; ++i) na += a[i] * a[i];
+        for (size_t i = 0; i < m; ++i) nb += b[i] * b[i];
+        return 5.0 * numeric_limits<double>::epsilon() * max<size_t>(logN, 1) * sqrt(na) * sqrt(nb);
+    }
+
+}
+
+/**
+ * Element ciała GF(P) dla nieparzystej liczby pierwszej P < 2^30, przechowywany w postaci Montgomery'ego (aR mod P, R = 2^32):
+ * mnożenie to jedno mnożenie 32x32 -> 64 bity i redukcja bez dzielenia. Tablica LiczbaModulo<P> ma układ tablicy uint32_t,
+ * co wykorzystują wektorowe jądra NTT.
+ */
+template <uint32_t P>
+class LiczbaModulo {
+    static_assert(P % 2 == 1 && P > 2 && P < (1u << 30), "Modul musi byc nieparzysta liczba pierwsza mniejsza niz 2^30.");
+
+private:
+    uint32_t m = 0;
+
+    static constexpr uint32_t odwrotnoscP() {
+        uint32_t x = P;                                 // P * P = 1 (mod 8): trzy poprawne bity
+        for (int i = 0; i < 4; ++i) x *= 2 - P * x;     // każdy krok Newtona podwaja ich liczbę
+        return x;
+    }
+
+public:
+    static constexpr uint32_t modul = P;
+    static constexpr uint32_t pOdwrotneUjemne = 0u - odwrotnoscP();                 // -P^-1 mod 2^32
+    static constexpr uint32_t r2 = uint32_t(((unsigned __int128)1 << 64) % P);      // R^2 mod P
+
+    /**
+     * Redukcja Montgomery'ego: t * R^-1 mod P dla t < P * 2^32.
+     */
+    static constexpr uint32_t redukuj(uint64_t t) {
+        uint32_t q = uint32_t(t) * pOdwrotneUjemne;
+        uint32_t u = uint32_t((t + uint64_t(q) * P) >> 32);
+        return u >= P ? u - P : u;
+    }
+
+    constexpr LiczbaModulo() = default;
+
+    constexpr LiczbaModulo(long long x) {
+        x %= (long long)P;
+        if (x < 0) x += P;
+        m = redukuj(uint64_t(x) * r2);
+    }
+
+    /**
+     * Element o podanej reprezentacji Montgomery'ego (aR mod P).
+     */
+    static constexpr LiczbaModulo zSurowej(uint32_t surowa) {
+        LiczbaModulo w;
+        w.m = surowa;
+        return w;
+    }
+
+    constexpr uint32_t surowa() const { return m; }
+
+    /**
+     * Wartość z przedziału [0, P).
+     */
+    constexpr uint32_t wartosc() const { return redukuj(m); }
+
+    constexpr LiczbaModulo& operator+=(LiczbaModulo o) {
+        m += o.m;
+        if (m >= P) m -= P;
+        return *this;
+    }
+
+    constexpr LiczbaModulo& operator-=(LiczbaModulo o) {
+        m = m >= o.m ? m - o.m : m + P - o.m;
+        return *this;
+    }
+
+    constexpr LiczbaModulo& operator*=(LiczbaModulo o) {
+        m = redukuj(uint64_t(m) * o.m);
+        return *this;
+    }
+
+    constexpr LiczbaModulo& operator/=(LiczbaModulo o) { return *this *= o.odwrotnosc(); }
+
+    constexpr LiczbaModulo operator-() const { return zSurowej(m ? P - m : 0); }
+
+    friend constexpr LiczbaModulo operator+(LiczbaModulo a, LiczbaModulo b) { return a += b; }
+    friend constexpr LiczbaModulo operator-(LiczbaModulo a, LiczbaModulo b) { return a -= b; }
+    friend constexpr LiczbaModulo operator*(LiczbaModulo a, LiczbaModulo b) { return a *= b; }
+    friend constexpr LiczbaModulo operator/(LiczbaModulo a, LiczbaModulo b) { return a /= b; }
+    friend constexpr bool operator==(LiczbaModulo a, LiczbaModulo b) { return a.m == b.m; }
+
+    constexpr LiczbaModulo potega(uint64_t e) const {
+        LiczbaModulo wynik(1), b = *this;
+        for (; e; e >>= 1, b *= b)
+            if (e & 1) wynik *= b;
+        return wynik;
+    }
+
+    /**
+     * Odwrotność z małego twierdzenia Fermata (a^(P-2)).
+     */
+    constexpr LiczbaModulo odwrotnosc() const {
+        if (m == 0) throw domain_error("Zero nie ma odwrotnosci modulo p.");
+        return potega(P - 2);
+    }
+
+    friend ostream& operator<<(ostream& os, LiczbaModulo a) { return os << a.wartosc(); }
+};
+
+template <class T>
+struct jestLiczbaModulo : false_type {};
+
+template <uint32_t P>
+struct jestLiczbaModulo<LiczbaModulo<P>> : true_type {};
+
+namespace detail {
+    /**
+     * Moduł i stała Montgomery'ego przekazywane do jąder NTT działających na surowych tablicach uint32_t.
+     */
+    struct ParametryModulu {
+        uint32_t p, pOdwrotneUjemne;
+    };
+
+    inline uint32_t mnozMontgomery(uint32_t a, uint32_t b, ParametryModulu mod) {
+        uint64_t t = uint64_t(a) * b;
+        uint32_t q = uint32_t(t) * mod.pOdwrotneUjemne;
+        uint32_t u = uint32_t((t + uint64_t(q) * mod.p) >> 32);
+        return u >= mod.p ? u - mod.p : u;
+    }
+
+    /**
+     * Jeden poziom NTT z decymacją w częstotliwości (Gentleman–Sande): naturalna kolejność na wejściu,
+     * odwrócona bitowo na wyjściu. w[len + j] to pierwiastek stopnia 2len z jedności do potęgi j.
+     */
+    inline void poziomDIF(uint32_t* a, size_t n, size_t len, const uint32_t* w, ParametryModulu mod) {
+        for (size_t i = 0; i < n; i += 2 * len)
+            for (size_t j = 0; j < len; ++j) {
+                uint32_t u = a[i + j], v = a[i + j + len];
+                uint32_t s = u + v, d = u + mod.p - v;
+                a[i + j] = s >= mod.p ? s - mod.p : s;
+                a[i + j + len] = mnozMontgomery(d, w[len + j], mod);
+            }
+    }
+
+    /**
+     * Jeden poziom NTT z decymacją w czasie (Cooley–Tukey): odwrotność poziomDIF dla odwrotnych pierwiastków.
+     */
+    inline void poziomDIT(uint32_t* a, size_t n, size_t len, const uint32_t* w, ParametryModulu mod) {
+        for (size_t i = 0; i < n; i += 2 * len)
+            for (size_t j = 0; j < len; ++j) {
+                uint32_t u = a[i + j], v = mnozMontgomery(a[i + j + len], w[len + j], mod);
+                uint32_t s = u + v, d = u + mod.p - v;
+                a[i + j] = s >= mod.p ? s - mod.p : s;
+                a[i + j + len] = d >= mod.p ? d - mod.p : d;
+            }
+    }
+
+    inline void nttDIFSkalarnie(uint32_t* a, size_t n, const uint32_t* w, ParametryModulu mod) {
+        for (size_t len = n / 2; len >= 1; len /= 2) poziomDIF(a, n, len, w, mod);
+    }
+
+    inline void nttDITSkalarnie(uint32_t* a, size_t n, const uint32_t* w, ParametryModulu mod) {
+        for (size_t len = 1; len < n; len *= 2) poziomDIT(a, n, len, w, mod);
+    }
+
+    /**
+     * a[i] = a[i] * b[i] * c (wszystko w postaci Montgomery'ego); c wnosi czynnik 1/n transformaty odwrotnej.
+     */
+    inline void mnozPunktowoSkalarnie(uint32_t* a, const uint32_t* b, size_t n, uint32_t c, ParametryModulu mod) {
+        for (size_t i = 0; i < n; ++i) a[i] = mnozMontgomery(mnozMontgomery(a[i], b[i], mod), c, mod);
+    }
+
+#ifdef WIELOMIAN_X86_SIMD
+    /**
+     * Osiem mnożeń Montgomery'ego naraz: iloczyny 64-bitowe liczone osobno dla parzystych i nieparzystych pozycji.
+     */
+    __attribute__((target("avx2")))
+    inline __m256i mnozMontgomeryAVX2(__m256i a, __m256i b, __m256i p, __m256i pOdwr) {
+        __m256i parzyste = _mm256_mul_epu32(a, b);
+        __m256i nieparzyste = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+        __m256i qp = _mm256_mul_epu32(parzyste, pOdwr), qn = _mm256_mul_epu32(nieparzyste, pOdwr);
+        parzyste = _mm256_add_epi64(parzyste, _mm256_mul_epu32(qp, p));
+        nieparzyste = _mm256_add_epi64(nieparzyste, _mm256_mul_epu32(qn, p));
+        __m256i u = _mm256_blend_epi32(_mm256_srli_epi64(parzyste, 32), nieparzyste, 0xAA);
+        return _mm256_min_epu32(u, _mm256_sub_epi32(u, p));     // u - p zawija się powyżej u, gdy u < p
+    }
+
+    __attribute__((target("avx2")))
+    inline void nttDIFAVX2(uint32_t* a, size_t n, const uint32_t* w, ParametryModulu mod) {
+        __m256i p = _mm256_set1_epi32(int(mod.p)), po = _mm256_set1_epi32(int(mod.pOdwrotneUjemne));
+        for (size_t len = n / 2; len >= 1; len /= 2) {
+            if (len < 8) {
+                poziomDIF(a, n, len, w, mod);
+                continue;
+            }
+            for (size_t i = 0; i < n; i += 2 * len)
+                for (size_t j = 0; j < len; j += 8) {
+                    __m256i u = _mm256_loadu_si256((const __m256i*)(a + i + j));
+                    __m256i v = _mm256_loadu_si256((const __m256i*)(a + i + j + len));
+                    __m256i s = _mm256_add_epi32(u, v), d = _mm256_add_epi32(_mm256_sub_epi32(u, v), p);
+                    s = _mm256_min_epu32(s, _mm256_sub_epi32(s, p));
+                    d = mnozMontgomeryAVX2(d, _mm256_loadu_si256((const __m256i*)(w + len + j)), p, po);
+                    _mm256_storeu_si256((__m256i*)(a + i + j), s);
+                    _mm256_storeu_si256((__m256i*)(a + i + j + len), d);
+                }
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline void nttDITAVX2(uint32_t* a, size_t n, const uint32_t* w, ParametryModulu mod) {
+        __m256i p = _mm256_set1_epi32(int(mod.p)), po = _mm256_set1_epi32(int(mod.pOdwrotneUjemne));
+        for (size_t len = 1; len < n; len *= 2) {
+            if (len < 8) {
+                poziomDIT(a, n, len, w, mod);
+                continue;
+            }
+            for (size_t i = 0; i < n; i += 2 * len)
+                for (size_t j = 0; j < len; j += 8) {
+                    __m256i u = _mm256_loadu_si256((const __m256i*)(a + i + j));
+                    __m256i v = _mm256_loadu_si256((const __m256i*)(a + i + j + len));
+                    v = mnozMontgomeryAVX2(v, _mm256_loadu_si256((const __m256i*)(w + len + j)), p, po);
+                    __m256i s = _mm256_add_epi32(u, v), d = _mm256_add_epi32(_mm256_sub_epi32(u, v), p);
+                    _mm256_storeu_si256((__m256i*)(a + i + j), _mm256_min_epu32(s, _mm256_sub_epi32(s, p)));
+                    _mm256_storeu_si256((__m256i*)(a + i + j + len), _mm256_min_epu32(d, _mm256_sub_epi32(d, p)));
+                }
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline void mnozPunktowoAVX2(uint32_t* a, const uint32_t* b, size_t n, uint32_t c, ParametryModulu mod) {
+        __m256i p = _mm256_set1_epi32(int(mod.p)), po = _mm256_set1_epi32(int(mod.pOdwrotneUjemne));
+        __m256i vc = _mm256_set1_epi32(int(c));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = mnozMontgomeryAVX2(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)), p, po);
+            _mm256_storeu_si256((__m256i*)(a + i), mnozMontgomeryAVX2(x, vc, p, po));
+        }
+        mnozPunktowoSkalarnie(a + i, b + i, n - i, c, mod);
+    }
+#endif
+
+    struct JadraNTT {
+        void (*dif)(uint32_t*, size_t, const uint32_t*, ParametryModulu);
+        void (*dit)(uint32_t*, size_t, const uint32_t*, ParametryModulu);
+        void (*punktowo)(uint32_t*, const uint32_t*, size_t, uint32_t, ParametryModulu);
+    };
+
+    inline JadraNTT wybierzJadraNTT() {
+#ifdef WIELOMIAN_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return { nttDIFAVX2, nttDITAVX2, mnozPunktowoAVX2 };
+#endif
+        return { nttDIFSkalarnie, nttDITSkalarnie, mnozPunktowoSkalarnie };
+    }
+
+    /**
+     * Najmniejszy pierwiastek pierwotny modulo liczba pierwsza p (rozkład p - 1 przez próbne dzielenie).
+     */
+    inline uint32_t pierwiastekPierwotny(uint32_t p) {
+        vector<uint32_t> dzielniki;
+        uint32_t r = p - 1;
+        for (uint32_t d = 2; uint64_t(d) * d <= r; ++d)
+            if (r % d == 0) {
+                dzielniki.push_back(d);
+                while (r % d == 0) r /= d;
+            }
+        if (r > 1) dzielniki.push_back(r);
+
+        auto potega = [p](uint64_t b, uint64_t e) {
+            uint64_t w = 1;
+            for (b %= p; e; e >>= 1, b = b * b % p)
+                if (e & 1) w = w * b % p;
+            return w;
+        };
+        for (uint32_t g = 2;; ++g) {
+            bool pierwotny = true;
+            for (uint32_t d : dzielniki) pierwotny = pierwotny && potega(g, (p - 1) / d) != 1;
+            if (pierwotny) return g;
+        }
+    }
+
+    /**
+     * Największa długość NTT modulo P: najwyższa potęga dwójki dzieląca P - 1.
+     */
+    template <uint32_t P>
+    constexpr size_t maksDlugoscNTT() { return size_t(1) << __builtin_ctz(P - 1); }
+
+    /**
+     * Tablica pierwiastków (prostych albo odwrotnych) dla NTT długości n w postaci Montgomery'ego:
+     * w[len + j] = omega_{2len}^j. Trzymana per wątek i powiększana w miarę potrzeb, jak korzenieFFT.
+     */
+    template <uint32_t P>
+    const vector<uint32_t>& korzenieNTT(size_t n, bool odwrotne) {
+        thread_local vector<uint32_t> tablice[2];
+        vector<uint32_t>& w = tablice[odwrotne];
+        if (w.size() >= n) return w;
+
+        static const uint32_t g = pierwiastekPierwotny(P);
+        w.assign(n, 0);
+        for (size_t len = 1; len < n; len *= 2) {
+            LiczbaModulo<P> omega = LiczbaModulo<P>(g).potega((P - 1) / (2 * len));
+            if (odwrotne) omega = omega.odwrotnosc();
+            LiczbaModulo<P> x(1);
+            for (size_t j = 0; j < len; ++j, x *= omega) w[len + j] = x.surowa();
+        }
+        return w;
+    }
+
+    /**
+     * Iloczyn nad GF(P) przez NTT: dwie transformaty w przód (DIF), mnożenie punktowe razem z czynnikiem 1/N
+     * i transformata odwrotna (DIT), bez permutacji bitowej. Wymaga n + m - 1 <= maksDlugoscNTT<P>().
+     */
+    template <uint32_t P>
+    vector<LiczbaModulo<P>> mnozNTT(const LiczbaModulo<P>* a, size_t n, const LiczbaModulo<P>* b, size_t m) {
+        static const JadraNTT jadra = wybierzJadraNTT();
+        const ParametryModulu mod{ P, LiczbaModulo<P>::pOdwrotneUjemne };
+        size_t dl = n + m - 1, N = 1;
+        while (N < dl) N *= 2;
+
+        vector<LiczbaModulo<P>> fa(N), fb(N);
+        copy(a, a + n, fa.begin());
+        copy(b, b + m, fb.begin());
+        uint32_t* ua = reinterpret_cast<uint32_t*>(fa.data());
+        uint32_t* ub = reinterpret_cast<uint32_t*>(fb.data());
+
+        const vector<uint32_t>& w = korzenieNTT<P>(N, false);
+        jadra.dif(ua, N, w.data(), mod);
+        jadra.dif(ub, N, w.data(), mod);
+        jadra.punktowo(ua, ub, N, LiczbaModulo<P>((long long)N).odwrotnosc().surowa(), mod);
+        jadra.dit(ua, N, korzenieNTT<P>(N, true).data(), mod);
+        fa.resize(dl);
+        return fa;
+    }
+
+    /**
+     * Reszty iloczynu całkowitego modulo P (wartości z [0, P)).
+     */
+    template <uint32_t P, class I>
+    vector<uint32_t> resztyIloczynu(const I* a, size_t n, const I* b, size_t m) {
+        vector<LiczbaModulo<P>> ra(n), rb(m);
+        for (size_t i = 0; i < n; ++i) ra[i] = LiczbaModulo<P>((long long)a[i]);
+        for (size_t i = 0; i < m; ++i) rb[i] = LiczbaModulo<P>((long long)b[i]);
+        vector<LiczbaModulo<P>> iloczyn = min(n, m) >= ProgiMnozenia::ntt
+            ? mnozNTT(ra.data(), n, rb.data(), m)
+            : mnozKaratsuba(ra.data(), n, rb.data(), m, ProgiMnozenia::karatsuba);
+        vector<uint32_t> wynik(iloczyn.size());
+        for (size_t i = 0; i < wynik.size(); ++i) wynik[i] = iloczyn[i].wartosc();
+        return wynik;
+    }
+
+    inline constexpr uint32_t modulyCRT[] = { 998244353, 754974721, 469762049, 167772161 };
+
+    /**
+     * Dokładny iloczyn wielomianów o współczynnikach całkowitych: reszty modulo kilku liczb pierwszych NTT
+     * (tyle, ile wymaga oszacowanie |c_k| <= min(n, m) * max|a| * max|b|) składane algorytmem Garnera
+     * w wartości z przedziału symetrycznego. Zwraca false, gdy nie wystarczają cztery moduły (ok. 2^115)
+     * albo iloczyn jest dłuższy niż najkrótsza dopuszczalna NTT (2^23).
+     */
+    template <class I>
+    bool mnozCalkowite(const I* a, size_t n, const I* b, size_t m, vector<__int128>& wynik) {
+        auto maksimum = [](const I* x, size_t k) {
+            double w = 0;
+            for (size_t i = 0; i < k; ++i) w = max(w, abs(double(x[i])));
+            return w;
+        };
+        if (n + m - 1 > maksDlugoscNTT<modulyCRT[0]>()) return false;
+        double ma = maksimum(a, n), mb = maksimum(b, m);
+        wynik.assign(n + m - 1, 0);
+        if (ma == 0 || mb == 0) return true;
+
+        double potrzebneBity = log2(double(min(n, m))) + log2(ma) + log2(mb) + 2;
+        size_t ile = 0;
+        for (double bity = 0; ile < 4 && bity <= potrzebneBity; ++ile) bity += log2(double(modulyCRT[ile]));
+        if (ile == 4 && log2(double(modulyCRT[0])) + log2(double(modulyCRT[1])) + log2(double(modulyCRT[2])) + log2(double(modulyCRT[3])) <= potrzebneBity)
+            return false;
+
+        vector<uint32_t> reszty[4];
+        reszty[0] = resztyIloczynu<modulyCRT[0]>(a, n, b, m);
+        if (ile > 1) reszty[1] = resztyIloczynu<modulyCRT[1]>(a, n, b, m);
+        if (ile > 2) reszty[2] = resztyIloczynu<modulyCRT[2]>(a, n, b, m);
+        if (ile > 3) reszty[3] = resztyIloczynu<modulyCRT[3]>(a, n, b, m);
+
+        auto potega = [](uint64_t x, uint64_t e, uint64_t p) {
+            uint64_t w = 1;
+            for (x %= p; e; e >>= 1, x = x * x % p)
+                if (e & 1) w = w * x % p;
+            return w;
+        };
+        // odwr[i] = (p_0 * ... * p_{i-1})^-1 mod p_i
+        uint64_t odwr[4];
+        unsigned __int128 iloczynModulow = 1;
+        for (size_t i = 0; i < ile; ++i) {
+            uint64_t p = modulyCRT[i], pref = 1;
+            for (size_t j = 0; j < i; ++j) pref = pref * modulyCRT[j] % p;
+            odwr[i] = potega(pref, p - 2, p);
+            iloczynModulow *= modulyCRT[i];
+        }
+
+        for (size_t k = 0; k < wynik.size(); ++k) {
+            uint64_t c[4];
+            unsigned __int128 x = 0, pref = 1;
+            for (size_t i = 0; i < ile; ++i) {
+                uint64_t p = modulyCRT[i], v = 0, mnoznik = 1;
+                for (size_t j = 0; j < i; ++j) {
+                    v = (v + c[j] % p * mnoznik) % p;
+                    mnoznik = mnoznik * modulyCRT[j] % p;
+                }
+                c[i] = (reszty[i][k] + p - v) % p * odwr[i] % p;
+                x += pref * c[i];
+                pref *= modulyCRT[i];
+            }
+            wynik[k] = x > iloczynModulow / 2 ? -__int128(iloczynModulow - x) : __int128(x);
+        }
+        return true;
+    }
+
+    /**
+     * Iloczyn dokładny dla double o wartościach całkowitych (|c| < 2^62), zaokrąglony raz na końcu.
+     * Zwraca false, gdy dane nie są całkowite albo wynik nie mieści się w zakresie CRT.
+     */
+    inline bool mnozCalkowiteDouble(const double* a, size_t n, const double* b, size_t m, vector<double>& wynik) {
+        auto calkowite = [](const double* x, size_t k, vector<long long>& out) {
+            out.resize(k);
+            for (size_t i = 0; i < k; ++i) {
+                if (!(abs(x[i]) < 0x1p62) || x[i] != nearbyint(x[i])) return false;
+                out[i] = (long long)x[i];
+            }
+            return true;
+        };
+        vector<long long> ca, cb;
+        vector<__int128> dokladny;
+        if (!calkowite(a, n, ca) || !calkowite(b, m, cb) || !mnozCalkowite(ca.data(), n, cb.data(), m, dokladny))
+            return false;
+        wynik.resize(dokladny.size());
+        for (size_t i = 0; i < wynik.size(); ++i) wynik[i] = double(dokladny[i]);
+        return true;
+    }
+
+    /**
+     * Wybiera algorytm mnożenia na podstawie długości krótszego czynnika.
+     * FFT i kalibracja progów dotyczą double (float liczony jest w double, complex<double> ma własną FFT),
+     * NTT — LiczbaModulo i int64 (dokładnie, przez CRT); pozostałe typy mnożone są szkolnie albo Karatsubą.
+     * Czynniki double o wartościach całkowitych, dla których FFT nie gwarantuje błędu poniżej 1/2, mnożone są dokładnie przez CRT.
+     */
+    template <class T>
+    vector<T> mnoz(const T* a, size_t n, const T* b, size_t m) {
+        size_t k = min(n, m);
+        if (k >= 8) ProgiMnozenia::kalibrujRaz();   // krótsze czynniki kalibracja i tak zostawia mnożeniu szkolnemu
+        if constexpr (is_same_v<T, double>) {
+            if (k >= ProgiMnozenia::fft) {
+                vector<double> dokladny;
+                if (ograniczenieBleduFFT(a, n, b, m) >= 0.5 && mnozCalkowiteDouble(a, n, b, m, dokladny))
+                    return dokladny;
+                return mnozFFT(a, n, b, m);
+            }
+        }
+        if constexpr (is_same_v<T, float>) {
+            // float ma za mało bitów na FFT długich iloczynów: liczymy w double i zaokrąglamy raz
+            if (k >= ProgiMnozenia::fft) {
+                vector<double> da(a, a + n), db(b, b + m);
+                vector<double> iloczyn = mnoz(da.data(), n, db.data(), m);
+                return vector<float>(iloczyn.begin(), iloczyn.end());
+            }
+        }
+        if constexpr (is_same_v<T, complex<double>>) {
+            if (k >= ProgiMnozenia::fft)
+                return mnozFFTZespolone(a, n, b, m);
+        }
+        if constexpr (is_integral_v<T> && is_signed_v<T> && sizeof(T) == 8) {
+            // dokładnie przez CRT; gdy wynik nie mieści się w zakresie modułów, i tak przepełniłby int64
+            vector<__int128> dokladny;
+            if (k >= ProgiMnozenia::ntt && mnozCalkowite(a, n, b, m, dokladny))
+                return vector<T>(dokladny.begin(), dokladny.end());
+        }
+        if constexpr (jestLiczbaModulo<T>::value) {
+            if (k >= ProgiMnozenia::ntt && n + m - 1 <= maksDlugoscNTT<T::modul>())
+                return mnozNTT(a, n, b, m);
+        }
+        if (k >= ProgiMnozenia::karatsuba)
+            return mnozKaratsuba(a, n, b, m, ProgiMnozenia::karatsuba);
+
+        vector<T> wynik(n + m - 1, T(0));
+        mnozNaiwnie(a, n, b, m, wynik.data());
+        return wynik;
+    }
+
+    /**
+     * Czas (w sekundach) jednego wywołania f: najlepsza z trzech serii, z których każda trwa co najmniej 0.2 ms.
+     */
+    template <class F>
+    double zmierzCzas(F&& f) {
+        using zegar = chrono::steady_clock;
+        double najlepszy = numeric_limits<double>::infinity();
+        for (int seria = 0; seria < 3; ++seria) {
+            size_t powtorzenia = 0;
+            auto start = zegar::now();
+            chrono::duration<double> uplynelo{};
+            do {
+                f();
+                ++powtorzenia;
+                uplynelo = zegar::now() - start;
+            } while (uplynelo.count() < 2e-4);
+            najlepszy = min(najlepszy, uplynelo.count() / powtorzenia);
+        }
+        return najlepszy;
+    }
+}
+
+void ProgiMnozenia::kalibruj() {
+    vector<double> a(4096), b(4096);
+    for (size_t i = 0; i < a.size(); ++i) {     // deterministyczne, niezerowe dane testowe
+        a[i] = 1.0 + (i % 7) * 0.25;
+        b[i] = 2.0 - (i % 5) * 0.5;
+    }
+    volatile double ujscie = 0;  // nie pozwala kompilatorowi usunąć mierzonych obliczeń
+
+    // Próg Karatsuby: najmniejsze n, dla którego jeden poziom rekurencji jest szybszy niż mnożenie szkolne.
+    size_t progK = 256;
+    for (size_t n = 8; n <= 256; n += n / 2) {
+        vector<double> w(2 * n - 1);
+        double szkolne = detail::zmierzCzas([&] {
+            fill(w.begin(), w.end(), 0.0);
+            detail::mnozNaiwnie(a.data(), n, b.data(), n, w.data());
+            ujscie = ujscie + w[n];
+        });
+        double karat = detail::zmierzCzas([&] { ujscie = ujscie + detail::mnozKaratsuba(a.data(), n, b.data(), n, n)[n]; });
+        if (karat < szkolne) { progK = n; break; }
+    }
+
+    // Próg FFT: najmniejsze n, dla którego FFT wygrywa z Karatsubą o skalibrowanym progu.
+    size_t progF = 4096;
+    for (size_t n = max<size_t>(progK, 32); n <= 4096; n *= 2) {
+        double karat = detail::zmierzCzas([&] { ujscie = ujscie + detail::mnozKaratsuba(a.data(), n, b.data(), n, progK)[n]; });
+        double transformata = detail::zmierzCzas([&] { ujscie = ujscie + detail::mnozFFT(a.data(), n, b.data(), n)[n]; });
+        if (transformata < karat) { progF = n; break; }
+    }
+
+    fft = max(progF, progK);
+    karatsuba = progK;
+    skalibrowane.store(true, memory_order_release);
+}
+
+namespace detail {
+    /**
+     * Schemat Hornera dla ile punktów naraz, bez rozkazów wektorowych.
+     * Cztery niezależne łańcuchy przeplatamy, żeby procesor nie czekał na wynik poprzedniego mnożenia.
+     */
+    template <class T>
+    void hornerSkalarnie(const T* w, size_t n, const T* xs, T* out, size_t ile) {
+        size_t p = 0;
+        for (; p + 4 <= ile; p += 4) {
+            T x0 = xs[p], x1 = xs[p + 1], x2 = xs[p + 2], x3 = xs[p + 3];
+            T y0 = T(0), y1 = T(0), y2 = T(0), y3 = T(0);
+            for (size_t i = n; i-- > 0;) {
+                y0 = y0 * x0 + w[i];
+                y1 = y1 * x1 + w[i];
+                y2 = y2 * x2 + w[i];
+                y3 = y3 * x3 + w[i];
+            }
+            out[p] = y0; out[p + 1] = y1; out[p + 2] = y2; out[p + 3] = y3;
+        }
+        for (; p < ile; ++p) {
+            T y = T(0);
+            for (size_t i = n; i-- > 0;) y = y * xs[p] + w[i];
+            out[p] = y;
+        }
+    }
+
+#ifdef WIELOMIAN_X86_SIMD
+    /**
+     * Horner na AVX2 + FMA: cztery łańcuchy po cztery punkty (16 punktów na iterację).
+     */
+    __attribute__((target("avx2,fma")))
+    inline void hornerAVX2(const double* w, size_t n, const double* xs, double* out, size_t ile) {
+        size_t p = 0;
+        for (; p + 16 <= ile; p += 16) {
+            __m256d x0 = _mm256_loadu_pd(xs + p), x1 = _mm256_loadu_pd(xs + p + 4);
+            __m256d x2 = _mm256_loadu_pd(xs + p + 8), x3 = _mm256_loadu_pd(xs + p + 12);
+            __m256d y0 = _mm256_setzero_pd(), y1 = y0, y2 = y0, y3 = y0;
+            for (size_t i = n; i-- > 0;) {
+                __m256d c = _mm256_broadcast_sd(w + i);
+                y0 = _mm256_fmadd_pd(y0, x0, c);
+                y1 = _mm256_fmadd_pd(y1, x1, c);
+                y2 = _mm256_fmadd_pd(y2, x2, c);
+                y3 = _mm256_fmadd_pd(y3, x3, c);
+            }
+            _mm256_storeu_pd(out + p, y0); _mm256_storeu_pd(out + p + 4, y1);
+            _mm256_storeu_pd(out + p + 8, y2); _mm256_storeu_pd(out + p + 12, y3);
+        }
+        for (; p + 4 <= ile; p += 4) {
+            __m256d x = _mm256_loadu_pd(xs + p), y = _mm256_setzero_pd();
+            for (size_t i = n; i-- > 0;) y = _mm256_fmadd_pd(y, x, _mm256_broadcast_sd(w + i));
+            _mm256_storeu_pd(out + p, y);
+        }
+        hornerSkalarnie(w, n, xs + p, out + p, ile - p);
+    }
+
+    /**
+     * Horner na AVX-512: cztery łańcuchy po osiem punktów (32 punkty na iterację).
+     */
+    __attribute__((target("avx512f")))
+    inline void hornerAVX512(const double* w, size_t n, const double* xs, double* out, size_t ile) {
+        size_t p = 0;
+        for (; p + 32 <= ile; p += 32) {
+            __m512d x0 = _mm512_loadu_pd(xs + p), x1 = _mm512_loadu_pd(xs + p + 8);
+            __m512d x2 = _mm512_loadu_pd(xs + p + 16), x3 = _mm512_loadu_pd(xs + p + 24);
+            __m512d y0 = _mm512_setzero_pd(), y1 = y0, y2 = y0, y3 = y0;
+            for (size_t i = n; i-- > 0;) {
+                __m512d c = _mm512_set1_pd(w[i]);
+                y0 = _mm512_fmadd_pd(y0, x0, c);
+                y1 = _mm512_fmadd_pd(y1, x1, c);
+                y2 = _mm512_fmadd_pd(y2, x2, c);
+                y3 = _mm512_fmadd_pd(y3, x3, c);
+            }
+            _mm512_storeu_pd(out + p, y0); _mm512_storeu_pd(out + p + 8, y1);
+            _mm512_storeu_pd(out + p + 16, y2); _mm512_storeu_pd(out + p + 24, y3);
+        }
+        for (; p + 8 <= ile; p += 8) {
+            __m512d x = _mm512_loadu_pd(xs + p), y = _mm512_setzero_pd();
+            for (size_t i = n; i-- > 0;) y = _mm512_fmadd_pd(y, x, _mm512_set1_pd(w[i]));
+            _mm512_storeu_pd(out + p, y);
+        }
+        hornerSkalarnie(w, n, xs + p, out + p, ile - p);
+    }
+
+    /**
+     * Horner float na AVX2 + FMA: cztery łańcuchy po osiem punktów (32 punkty na iterację).
+     */
+    __attribute__((target("avx2,fma")))
+    inline void hornerAVX2(const float* w, size_t n, const float* xs, float* out, size_t ile) {
+        size_t p = 0;
+        for (; p + 32 <= ile; p += 32) {
+            __m256 x0 = _mm256_loadu_ps(xs + p), x1 = _mm256_loadu_ps(xs + p + 8);
+            __m256 x2 = _mm256_loadu_ps(xs + p + 16), x3 = _mm256_loadu_ps(xs + p + 24);
+            __m256 y0 = _mm256_setzero_ps(), y1 = y0, y2 = y0, y3 = y0;
+            for (size_t i = n; i-- > 0;) {
+                __m256 c = _mm256_broadcast_ss(w + i);
+                y0 = _mm256_fmadd_ps(y0, x0, c);
+                y1 = _mm256_fmadd_ps(y1, x1, c);
+                y2 = _mm256_fmadd_ps(y2, x2, c);
+                y3 = _mm256_fmadd_ps(y3, x3, c);
+            }
+            _mm256_storeu_ps(out + p, y0); _mm256_storeu_ps(out + p + 8, y1);
+            _mm256_storeu_ps(out + p + 16, y2); _mm256_storeu_ps(out + p + 24, y3);
+        }
+        for (; p + 8 <= ile; p += 8) {
+            __m256 x = _mm256_loadu_ps(xs + p), y = _mm256_setzero_ps();
+            for (size_t i = n; i-- > 0;) y = _mm256_fmadd_ps(y, x, _mm256_broadcast_ss(w + i));
+            _mm256_storeu_ps(out + p, y);
+        }
+        hornerSkalarnie(w, n, xs + p, out + p, ile - p);
+    }
+
+    /**
+     * Horner float na AVX-512: cztery łańcuchy po szesnaście punktów (64 punkty na iterację).
+     */
+    __attribute__((target("avx512f")))
+    inline void hornerAVX512(const float* w, size_t n, const float* xs, float* out, size_t ile) {
+        size_t p = 0;
+        for (; p + 64 <= ile; p += 64) {
+            __m512 x0 = _mm512_loadu_ps(xs + p), x1 = _mm512_loadu_ps(xs + p + 16);
+            __m512 x2 = _mm512_loadu_ps(xs + p + 32), x3 = _mm512_loadu_ps(xs + p + 48);
+            __m512 y0 = _mm512_setzero_ps(), y1 = y0, y2 = y0, y3 = y0;
+            for (size_t i = n; i-- > 0;) {
+                __m512 c = _mm512_set1_ps(w[i]);
+                y0 = _mm512_fmadd_ps(y0, x0, c);
+                y1 = _mm512_fmadd_ps(y1, x1, c);
+                y2 = _mm512_fmadd_ps(y2, x2, c);
+                y3 = _mm512_fmadd_ps(y3, x3, c);
+            }
+            _mm512_storeu_ps(out + p, y0); _mm512_storeu_ps(out + p + 16, y1);
+            _mm512_storeu_ps(out + p + 32, y2); _mm512_storeu_ps(out + p + 48, y3);
+        }
+        for (; p + 16 <= ile; p += 16) {
+            __m512 x = _mm512_loadu_ps(xs + p), y = _mm512_setzero_ps();
+            for (size_t i = n; i-- > 0;) y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(w[i]));
+            _mm512_storeu_ps(out + p, y);
+        }
+        hornerSkalarnie(w, n, xs + p, out + p, ile - p);
+    }
+#endif
+
+    template <class T>
+    using FunkcjaHornera = void (*)(const T*, size_t, const T*, T*, size_t);
+
+    /**
+     * Wybiera najszerszy wariant Hornera obsługiwany przez procesor. Sprawdzane raz, przy pierwszym użyciu.
+     * Jądra wektorowe są tylko dla double i float; pozostałe typy liczone są skalarnie.
+     */
+    template <class T>
+    FunkcjaHornera<T> wybierzHornera() {
+#ifdef WIELOMIAN_X86_SIMD
+        if constexpr (is_same_v<T, double> || is_same_v<T, float>) {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return hornerAVX512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return hornerAVX2;
+        }
+#endif
+        return hornerSkalarnie<T>;
+    }
+
+    /**
+     * Wartości wielomianu o współczynnikach w[0..n) w punktach xs[0..ile).
+     */
+    template <class T>
+    void hornerWielu(const T* w, size_t n, const T* xs, T* out, size_t ile) {
+        static const FunkcjaHornera<T> horner = wybierzHornera<T>();
+        horner(w, n, xs, out, ile);
+    }
+
+    /**
+     * Zamienia współczynniki Taylora p^(j)(x) / j! w bloku [ile][k + 1] na pochodne p^(j)(x).
+     */
+    template <class T>
+    void mnozPrzezSilnie(T* out, size_t k, size_t ile) {
+        for (size_t p = 0; p < ile; ++p) {
+            T silnia = T(1);
+            for (size_t j = 2; j <= k; ++j) {
+                silnia *= T(j);
+                out[p * (k + 1) + j] *= silnia;
+            }
+        }
+    }
+
+    /**
+     * Horner z pochodnymi: jedno przejście po w[0..n) daje p(x), p'(x), ..., p^(k)(x) dla każdego punktu,
+     * out[p * (k + 1) + j] = p^(j)(xs[p]). Akumulator j w kroku i przyjmuje b_j = b_j * x + b_{j-1},
+     * więc na końcu b_j = p^(j)(x) / j! — żadna pochodna nie jest budowana jako osobny wielomian.
+     */
+    template <class T>
+    void hornerPochodneSkalarnie(const T* w, size_t n, size_t k, const T* xs, T* out, size_t ile) {
+        for (size_t p = 0; p < ile; ++p) {
+            T x = xs[p];
+            T* b = out + p * (k + 1);
+            fill(b, b + k + 1, T(0));
+            for (size_t i = n; i-- > 0;) {
+                for (size_t j = min(k, n - 1 - i); j > 0; --j) b[j] = b[j] * x + b[j - 1];
+                b[0] = b[0] * x + w[i];
+            }
+        }
+        mnozPrzezSilnie(out, k, ile);
+    }
+
+#ifdef WIELOMIAN_X86_SIMD
+    /**
+     * Horner z pochodnymi na AVX2 + FMA, cztery punkty naraz. Akumulatory leżą w buforze [k + 1][4],
+     * który mieści się w pamięci podręcznej L1; wyniki są potem przepisywane do układu [punkt][pochodna].
+     */
+    __attribute__((target("avx2,fma")))
+    inline void hornerPochodneAVX2(const double* w, size_t n, size_t k, const double* xs, double* out, size_t ile) {
+        thread_local vector<double> akumulatory;
+        akumulatory.assign(4 * (k + 1), 0.0);
+        double* b = akumulatory.data();
+        size_t p = 0;
+        for (; p + 4 <= ile; p += 4) {
+            __m256d x = _mm256_loadu_pd(xs + p), b0 = _mm256_setzero_pd();
+            for (size_t j = 1; j <= k; ++j) _mm256_storeu_pd(b + 4 * j, b0);
+            for (size_t i = n; i-- > 0;) {
+                for (size_t j = min(k, n - 1 - i); j > 1; --j)
+                    _mm256_storeu_pd(b + 4 * j, _mm256_fmadd_pd(_mm256_loadu_pd(b + 4 * j), x, _mm256_loadu_pd(b + 4 * (j - 1))));
+                if (k > 0 && i + 1 < n) _mm256_storeu_pd(b + 4, _mm256_fmadd_pd(_mm256_loadu_pd(b + 4), x, b0));
+                b0 = _mm256_fmadd_pd(b0, x, _mm256_broadcast_sd(w + i));
+            }
+            _mm256_storeu_pd(b, b0);
+            for (size_t j = 0; j <= k; ++j)
+                for (size_t t = 0; t < 4; ++t) out[(p + t) * (k + 1) + j] = b[4 * j + t];
+        }
+        mnozPrzezSilnie(out, k, p);
+        hornerPochodneSkalarnie(w, n, k, xs + p, out + p * (k + 1), ile - p);
+    }
+#endif
+
+    template <class T>
+    using FunkcjaHorneraPochodnych = void (*)(const T*, size_t, size_t, const T*, T*, size_t);
+
+    template <class T>
+    FunkcjaHorneraPochodnych<T> wybierzHorneraPochodnych() {
+#ifdef WIELOMIAN_X86_SIMD
+        if constexpr (is_same_v<T, double>) {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return hornerPochodneAVX2;
+        }
+#endif
+        return hornerPochodneSkalarnie<T>;
+    }
+
+    /**
+     * p^(j)(xs[p]) dla j = 0..k, w układzie out[p * (k + 1) + j].
+     */
+    template <class T>
+    void hornerPochodnychWielu(const T* w, size_t n, size_t k, const T* xs, T* out, size_t ile) {
+        static const FunkcjaHorneraPochodnych<T> horner = wybierzHorneraPochodnych<T>();
+        horner(w, n, k, xs, out, ile);
+    }
+}
+
+/**
+ * Schemat obliczania wartości wielomianu w punkcie.
+ * Auto wybiera Hornera dla stopni poniżej Wielomian::progEstrina, a powyżej schemat hybrydowy.
+ */
+enum class SchematEwaluacji { Auto, Horner, Estrin, Hybryda };
+
+/**
+ * Sposób usuwania znikających współczynników przy najwyższych potęgach (po konstrukcji i po każdej operacji).
+ * Domyslna odsyła do Wielomian::domyslnaNormalizacja, Brak zachowuje długość bez zmian.
+ */
+enum class Normalizacja { Domyslna, Brak, DokladneZero, EpsilonBezwzgledny, EpsilonWzgledny };
+
+/**
+ * Normalizacja z progiem: współczynnik uznajemy za zero, gdy |c| <= epsilon (EpsilonBezwzgledny)
+ * albo |c| <= epsilon * max|c_i| (EpsilonWzgledny, który po każdej operacji przegląda wszystkie współczynniki);
+ * DokladneZero usuwa tylko c == 0.
+ */
+struct PolitykaNormalizacji {
+    Normalizacja rodzaj = Normalizacja::Domyslna;
+    double epsilon = 0;
+};
+
+namespace detail {
+    /**
+     * Klasyczny schemat Hornera: n - 1 zależnych od siebie kroków mnożenie + dodawanie.
+     */
+    template <class T>
+    T horner(const T* w, size_t n, T x) {
+        T wynik = T(0);
+        for (size_t i = n; i-- > 0;)     // Algorytm Hornera (ChatGPT)
+            wynik = wynik * x + w[i];
+        return wynik;
+    }
+
+    /**
+     * Schemat Estrina: współczynniki łączone parami z x, potem pary z x^2, czwórki z x^4 itd.
+     * Głębokość zależności to log2(n) zamiast n, kosztem bufora na n/2 wartości pośrednich.
+     */
+    template <class T>
+    T estrin(const T* w, size_t n, T x) {
+        if (n == 0) return T(0);
+        if (n == 1) return w[0];
+
+        T lokalny[128];
+        static thread_local vector<T> duzy;
+        size_t m = (n + 1) / 2;
+        T* t = lokalny;
+        if (m > 128) {
+            if (duzy.size() < m) duzy.resize(m);
+            t = duzy.data();
+        }
+
+        for (size_t i = 0; i < n / 2; ++i) t[i] = w[2 * i] + w[2 * i + 1] * x;
+        if (n % 2) t[m - 1] = w[n - 1];
+
+        T potega = x * x;
+        while (m > 1) {
+            size_t k = (m + 1) / 2;
+            for (size_t i = 0; i < m / 2; ++i) t[i] = t[2 * i] + t[2 * i + 1] * potega;
+            if (m % 2) t[k - 1] = t[m - 1];
+            m = k;
+            potega *= potega;
+        }
+        return t[0];
+    }
+
+    /**
+     * Estrin rozwinięty dla bloku 16 współczynników, przy gotowych potęgach x, x^2, x^4 i x^8.
+     */
+    template <class T>
+    T estrinBlok16(const T* c, T x, T x2, T x4, T x8) {
+        T p0 = c[0] + c[1] * x, p1 = c[2] + c[3] * x, p2 = c[4] + c[5] * x, p3 = c[6] + c[7] * x;
+        T p4 = c[8] + c[9] * x, p5 = c[10] + c[11] * x, p6 = c[12] + c[13] * x, p7 = c[14] + c[15] * x;
+        T q0 = p0 + p1 * x2, q1 = p2 + p3 * x2, q2 = p4 + p5 * x2, q3 = p6 + p7 * x2;
+        return (q0 + q1 * x4) + (q2 + q3 * x4) * x8;
+    }
+
+    /**
+     * Schemat hybrydowy: bloki po 16 współczynników liczone Estrinem, łączone Hornerem względem x^16.
+     * Nie potrzebuje bufora, a łańcuch zależności ma tylko jeden krok na blok.
+     */
+    template <class T>
+    T hybryda(const T* w, size_t n, T x) {
+        size_t bloki = n / 16, reszta = n % 16;
+        T wynik = horner(w + 16 * bloki, reszta, x);
+        if (bloki == 0) return wynik;
+
+        T x2 = x * x, x4 = x2 * x2, x8 = x4 * x4, x16 = x8 * x8;
+        for (size_t b = bloki; b-- > 0;)
+            wynik = wynik * x16 + estrinBlok16(w + 16 * b, x, x2, x4, x8);
+        return wynik;
+    }
+
+    /**
+     * Wartość wielomianu w[0..n) w punkcie x wybranym schematem (Auto musi być już rozstrzygnięte).
+     */
+    template <class T>
+    T wartosc(const T* w, size_t n, T x, SchematEwaluacji schemat) {
+        switch (schemat) {
+        case SchematEwaluacji::Estrin: return estrin(w, n, x);
+        case SchematEwaluacji::Hybryda: return hybryda(w, n, x);
+        default: return horner(w, n, x);
+        }
+    }
+}
+
+namespace detail {
+    /**
+     * Iloczyn krótki: pierwsze k współczynników a * b (reszta nie jest liczona, o ile pozwala na to algorytm).
+     * Małe czynniki mnożymy szkolnie tylko w trójkącie i + j < k; większe obcinamy do k i mnożymy przez mnoz.
+     */
+    template <class T>
+    vector<T> iloczynKrotki(const T* a, size_t n, const T* b, size_t m, size_t k) {
+        n = min(n, k);
+        m = min(m, k);
+        vector<T> wynik(k, T(0));
+        if (n == 0 || m == 0) return wynik;
+        if (min(n, m) < ProgiMnozenia::karatsuba) {
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < min(m, k - i); ++j)
+                    wynik[i + j] += a[i] * b[j];
+            return wynik;
+        }
+        vector<T> pelny = mnoz(a, n, b, m);
+        copy(pelny.begin(), pelny.begin() + min(k, pelny.size()), wynik.begin());
+        return wynik;
+    }
+
+    /**
+     * Iloczyn środkowy: współczynniki [od, od + ile) iloczynu a * b.
+     * Dla double powyżej progu FFT wystarcza splot cykliczny długości max(od + ile, n + m - 1 - od) zamiast n + m - 1:
+     * zawinięte współczynniki lądują poniżej od, czyli w części, której nie potrzebujemy.
+     * W iteracjach Newtona (n = 2m, od = m) to połowa długości pełnego iloczynu.
+     */
+    template <class T>
+    vector<T> iloczynSrodkowy(const T* a, size_t n, const T* b, size_t m, size_t od, size_t ile) {
+        n = min(n, od + ile);
+        m = min(m, od + ile);
+        vector<T> wynik(ile, T(0));
+        if (n == 0 || m == 0) return wynik;
+        if constexpr (is_same_v<T, double>) {
+            if (min(n, m) >= ProgiMnozenia::fft) {
+                size_t N = 1;
+                while (N < max({ od + ile, n + m - 1 - min(od, n + m - 1), n, m })) N *= 2;
+                vector<double> splot = splotCyklicznyFFT(a, n, b, m, N);
+                for (size_t i = 0; i < ile && od + i < n + m - 1; ++i) wynik[i] = splot[(od + i) & (N - 1)];
+                return wynik;
+            }
+        }
+        if (min(n, m) < ProgiMnozenia::karatsuba) {
+            for (size_t i = 0; i < n; ++i) {
+                size_t j0 = od > i ? od - i : 0, j1 = min(m, od + ile - i);
+                for (size_t j = j0; j < j1; ++j) wynik[i + j - od] += a[i] * b[j];
+            }
+            return wynik;
+        }
+        vector<T> pelny = mnoz(a, n, b, m);
+        for (size_t i = 0; i < ile && od + i < pelny.size(); ++i) wynik[i] = pelny[od + i];
+        return wynik;
+    }
+
+    /**
+     * Odwrotność szeregu potęgowego f (n współczynników) modulo x^k, liczona iteracją Newtona
+     * g <- g - g(fg - 1), która podwaja liczbę poprawnych współczynników w każdym kroku. Wymaga f[0] != 0.
+     */
+    template <class T>
+    vector<T> odwrotnoscSzeregu(const T* f, size_t n, size_t k) {
+        if (n == 0 || f[0] == T(0))
+            throw domain_error("Szereg o zerowym wyrazie wolnym nie jest odwracalny.");
+
+        vector<T> g{ T(1) / f[0] };
+        g.reserve(k);
+        for (size_t l = 1; l < k;) {
+            size_t l2 = min(2 * l, k);
+            // fg - 1 = x^l * E (mod x^l2): E to iloczyn środkowy, a poprawka g * E potrzebuje tylko l2 - l współczynników
+            vector<T> e = iloczynSrodkowy(f, min(n, l2), g.data(), g.size(), l, l2 - l);
+            vector<T> h = iloczynKrotki(g.data(), g.size(), e.data(), e.size(), l2 - l);
+            g.resize(l2);
+            for (size_t i = l; i < l2; ++i) g[i] = T(0) - h[i - l];
+            l = l2;
+        }
+        g.resize(k);
+        return g;
+    }
+
+    /**
+     * Wynik dzielenia wielomianów z resztą.
+     */
+    template <class T>
+    struct IlorazIReszta {
+        vector<T> iloraz;
+        vector<T> reszta;
+    };
+
+    /**
+     * Dzielenie pisemne O(m * (n - m + 1)) z resztą; dzielnik bez zer wiodących, n >= m.
+     */
+    template <class T>
+    IlorazIReszta<T> dzielNaiwnie(const T* a, size_t n, const T* b, size_t m) {
+        vector<T> r(a, a + n);
+        vector<T> q(n - m + 1, T(0));
+        for (size_t k = n - m + 1; k-- > 0;) {
+            T c = r[k + m - 1] / b[m - 1];
+            q[k] = c;
+            for (size_t j = 0; j < m; ++j) r[k + j] -= c * b[j];
+        }
+        r.resize(max<size_t>(m - 1, 1));
+        if (m == 1) r[0] = T(0);
+        return { q, r };
+    }
+
+    /**
+     * Dzielenie a przez b z resztą przez odwrócenie współczynników:
+     * rev(q) = rev(a) * rev(b)^(-1) mod x^(n - m + 1), po czym r = a - b*q. Koszt to kilka mnożeń.
+     * Odwrotność rev(b) może mieć współczynniki o wiele rzędów większe niż b (np. gdy b ma wiele pierwiastków
+     * w kole jednostkowym), a wtedy iloraz w double jest bezwartościowy. Dlatego sprawdzamy, czy b*q zgadza się z a
+     * na wyższych współczynnikach, i w razie rozbieżności dzielimy pisemnie, co jest w tej sytuacji stabilne.
+     */
+    template <class T>
+    IlorazIReszta<T> dzielNewtonem(const T* a, size_t n, const T* b, size_t m) {
+        while (m > 1 && b[m - 1] == T(0)) --m;     // zera wiodące dzielnika nie zmieniają wyniku
+        if (m == 0 || (m == 1 && b[0] == T(0)))
+            throw domain_error("Dzielenie przez wielomian zerowy.");
+        if (n < m)
+            return { vector<T>{ T(0) }, vector<T>(a, a + n) };
+
+        size_t k = n - m + 1;
+        vector<T> ra(k), rb(min(m, k));
+        for (size_t i = 0; i < k; ++i) ra[i] = a[n - 1 - i];
+        for (size_t i = 0; i < rb.size(); ++i) rb[i] = b[m - 1 - i];
+
+        vector<T> odwr = odwrotnoscSzeregu(rb.data(), rb.size(), k);
+        vector<T> q = mnoz(ra.data(), k, odwr.data(), k);
+        q.resize(k);
+        reverse(q.begin(), q.end());
+
+        vector<T> bq = mnoz(b, m, q.data(), k);
+        if constexpr (WspolczynnikPrzyblizony<T>) {
+            using Skalar = decltype(abs(T{}));
+            Skalar skala = 0, blad = 0;
+            for (size_t i = 0; i < n; ++i) skala = max(skala, abs(a[i]));
+            for (size_t i = m - 1; i < n; ++i) {
+                skala = max(skala, abs(bq[i]));
+                blad = max(blad, abs(a[i] - bq[i]));
+            }
+            if (!(blad <= sqrt(numeric_limits<Skalar>::epsilon()) * skala))
+                return dzielNaiwnie(a, n, b, m);
+        }
+
+        vector<T> r(max<size_t>(m - 1, 1), T(0));
+        for (size_t i = 0; i + 1 < m; ++i) r[i] = a[i] - bq[i];
+        return { q, r };
+    }
+
+    /**
+     * Dzielenie z resztą: pisemne dla krótkiego dzielnika lub ilorazu, powyżej ProgiMnozenia::newton przez dzielNewtonem.
+     */
+    template <class T>
+    IlorazIReszta<T> dziel(const T* a, size_t n, const T* b, size_t m) {
+        while (m > 1 && b[m - 1] == T(0)) --m;
+        if (m == 0 || (m == 1 && b[0] == T(0)))
+            throw domain_error("Dzielenie przez wielomian zerowy.");
+        if (n < m)
+            return { vector<T>{ T(0) }, vector<T>(a, a + n) };
+        if (min(m, n - m + 1) >= ProgiMnozenia::newton)
+            return dzielNewtonem(a, n, b, m);
+        return dzielNaiwnie(a, n, b, m);
+    }
+
+    inline size_t progWagInterpolacji = 2048;   // do tylu węzłów wagi M'(x_i) liczone są wprost, w O(n^2)
+
+    /**
+     * Drzewo iloczynów częściowych dla punktów x_0..x_{n-1}.
+     * poziomy[0][i] = x - x_i, a węzeł j na poziomie k to iloczyn dzieci 2j i 2j+1 z poziomu k - 1
+     * (węzeł bez pary przechodzi wyżej bez zmian). Korzeń to M(x) = (x - x_0)...(x - x_{n-1}).
+     */
+    struct DrzewoIloczynow {
+        vector<vector<vector<double>>> poziomy;
+
+        explicit DrzewoIloczynow(span<const double> xs) {
+            poziomy.emplace_back();
+            for (double x : xs) poziomy[0].push_back({ -x, 1.0 });
+
+            while (poziomy.back().size() > 1) {
+                const vector<vector<double>>& nizej = poziomy.back();
+                vector<vector<double>> wyzej;
+                for (size_t j = 0; j + 1 < nizej.size(); j += 2)
+                    wyzej.push_back(mnoz(nizej[j].data(), nizej[j].size(), nizej[j + 1].data(), nizej[j + 1].size()));
+                if (nizej.size() % 2) wyzej.push_back(nizej.back());
+                poziomy.push_back(move(wyzej));
+            }
+        }
+
+        const vector<double>& korzen() const { return poziomy.back()[0]; }
+
+        /**
+         * Wartości r w punktach węzła (k, j), zapisywane od out[j * 2^k].
+         * Schodzi w dół biorąc reszty z dzielenia przez dzieci; przy małej liczbie punktów kończy Hornerem.
+         */
+        void ewaluuj(const vector<double>& r, size_t k, size_t j, span<const double> xs, double* out) const {
+            size_t poczatek = j << k;
+            size_t ile = min(xs.size() - poczatek, size_t(1) << k);
+            if (k == 0 || ile <= 32) {
+                hornerWielu(r.data(), r.size(), xs.data() + poczatek, out + poczatek, ile);
+                return;
+            }
+            for (size_t dziecko = 2 * j; dziecko <= 2 * j + 1 && dziecko < poziomy[k - 1].size(); ++dziecko) {
+                const vector<double>& d = poziomy[k - 1][dziecko];
+                ewaluuj(dziel(r.data(), r.size(), d.data(), d.size()).reszta, k - 1, dziecko, xs, out);
+            }
+        }
+
+        /**
+         * Kombinacja liniowa sum_i c_i * M(x) / (x - x_i) liczona od liści w górę:
+         * wynik węzła = wynik_lewy * M_prawy + wynik_prawy * M_lewy.
+         */
+        vector<double> kombinacja(span<const double> c) const {
+            vector<vector<double>> biezace;
+            for (double ci : c) biezace.push_back({ ci });
+
+            for (size_t k = 1; k < poziomy.size(); ++k) {
+                vector<vector<double>> wyzej;
+                for (size_t j = 0; j + 1 < biezace.size(); j += 2) {
+                    const vector<double>& ml = poziomy[k - 1][j];
+                    const vector<double>& mp = poziomy[k - 1][j + 1];
+                    vector<double> a = mnoz(biezace[j].data(), biezace[j].size(), mp.data(), mp.size());
+                    vector<double> b = mnoz(biezace[j + 1].data(), biezace[j + 1].size(), ml.data(), ml.size());
+                    if (a.size() < b.size()) swap(a, b);
+                    for (size_t i = 0; i < b.size(); ++i) a[i] += b[i];
+                    wyzej.push_back(move(a));
+                }
+                if (biezace.size() % 2) wyzej.push_back(move(biezace.back()));
+                biezace = move(wyzej);
+            }
+            return biezace[0];
+        }
+    };
+}
+
+namespace detail {
+    inline size_t progPrzesuniecia = 32;   // do tej długości przesunięcie Taylora liczone jest kwadratowo
+    inline size_t progZlozenia = 8;        // do tej długości złożenie liczone jest schematem Hornera
+
+    /**
+     * Przesunięcie Taylora w miejscu, w(x) := w(x + a): n - 1 przebiegów schematu Hornera, O(n^2).
+     */
+    template <class T>
+    void przesunKwadratowo(T* w, size_t n, T a) {
+        for (size_t i = 0; i + 1 < n; ++i)
+            for (size_t j = n - 1; j-- > i;) w[j] += a * w[j + 1];
+    }
+
+    template <class T>
+    vector<T> przesunRekurencyjnie(const T* w, size_t n, T a, const vector<vector<T>>& potegi) {
+        if (n <= progPrzesuniecia) {
+            vector<T> wynik(w, w + n);
+            przesunKwadratowo(wynik.data(), n, a);
+            return wynik;
+        }
+        size_t k = 0;
+        while ((progPrzesuniecia << (k + 1)) < n) ++k;
+        size_t h = progPrzesuniecia << k;
+        vector<T> dol = przesunRekurencyjnie(w, h, a, potegi);
+        vector<T> gora = przesunRekurencyjnie(w + h, n - h, a, potegi);
+        vector<T> wynik = mnoz(potegi[k].data(), potegi[k].size(), gora.data(), gora.size());
+        for (size_t i = 0; i < h; ++i) wynik[i] += dol[i];
+        return wynik;
+    }
+
+    /**
+     * w(x + a) dziel i zwyciężaj: w = dol + x^h * gora daje dol(x + a) + (x + a)^h * gora(x + a),
+     * gdzie h = progPrzesuniecia * 2^k, a potęgi (x + a)^h liczone są raz, przez podnoszenie do kwadratu.
+     * Każdy poziom to mnożenia o łącznej długości n, razem O(M(n) log n). Nie dzieli przez silnie, więc działa
+     * dokładnie dla liczb całkowitych, a dla zmiennoprzecinkowych ma błąd zwykłego mnożenia.
+     */
+    template <class T>
+    vector<T> przesunTaylora(const T* w, size_t n, T a) {
+        vector<vector<T>> potegi;
+        if (n > progPrzesuniecia) {
+            vector<T> p(progPrzesuniecia + 1, T(0));
+            p.back() = T(1);
+            przesunKwadratowo(p.data(), p.size(), a);
+            potegi.push_back(move(p));
+            while ((progPrzesuniecia << potegi.size()) < n) {
+                const vector<T>& q = potegi.back();
+                potegi.push_back(mnoz(q.data(), q.size(), q.data(), q.size()));
+            }
+        }
+        return przesunRekurencyjnie(w, n, a, potegi);
+    }
+
+    /**
+     * w(x + a) nad ciałem, w którym 1, ..., n - 1 są odwracalne (GF(p), n <= p), jednym splotem, O(M(n)):
+     * współczynnik k wyniku to (1 / k!) * sum_i (w_i * i!) * a^(i - k) / (i - k)!, czyli splot odwróconego
+     * ciągu w_i * i! z ciągiem a^j / j!. Nad liczbami zmiennoprzecinkowymi bezużyteczne: składniki splotu
+     * rozciągają się od 1 do (n - 1)!, więc błąd FFT zjada niskie współczynniki.
+     */
+    template <class F>
+    vector<F> przesunSplotem(const vector<F>& w, F a) {
+        size_t n = w.size();
+        if (n == 0) return {};
+        vector<F> silnia(n), odwrSilni(n);
+        silnia[0] = F(1);
+        for (size_t i = 1; i < n; ++i) silnia[i] = silnia[i - 1] * F((long long)i);
+        odwrSilni[n - 1] = silnia[n - 1].odwrotnosc();
+        for (size_t i = n - 1; i > 0; --i) odwrSilni[i - 1] = odwrSilni[i] * F((long long)i);
+
+        vector<F> b(n), c(n);
+        F ai(1);
+        for (size_t i = 0; i < n; ++i) {
+            b[n - 1 - i] = w[i] * silnia[i];
+            c[i] = ai * odwrSilni[i];
+            ai *= a;
+        }
+        vector<F> d = mnoz(b.data(), n, c.data(), n);
+        vector<F> wynik(n);
+        for (size_t k = 0; k < n; ++k) wynik[k] = d[n - 1 - k] * odwrSilni[k];
+        return wynik;
+    }
+
+    template <class T>
+    vector<T> zlozRekurencyjnie(const T* w, size_t n, const vector<T>& q, const vector<vector<T>>& potegi) {
+        if (n <= progZlozenia) {
+            vector<T> wynik{ w[n - 1] };
+            for (size_t i = n - 1; i-- > 0;) {
+                wynik = mnoz(wynik.data(), wynik.size(), q.data(), q.size());
+                wynik[0] += w[i];
+            }
+            return wynik;
+        }
+        size_t k = size_t(bit_width(n - 1)) - 1;
+        size_t h = size_t(1) << k;
+        vector<T> dol = zlozRekurencyjnie(w, h, q, potegi);
+        vector<T> gora = zlozRekurencyjnie(w + h, n - h, q, potegi);
+        vector<T> wynik = mnoz(potegi[k].data(), potegi[k].size(), gora.data(), gora.size());
+        for (size_t i = 0; i < dol.size(); ++i) wynik[i] += dol[i];
+        return wynik;
+    }
+
+    /**
+     * w(q(x)) dziel i zwyciężaj (jak u Brenta i Kunga): w = dol + x^h * gora daje dol(q) + q^h * gora(q)
+     * dla h = 2^k, z potęgami q^(2^k) liczonymi raz; krótkie kawałki liczone są schematem Hornera.
+     * Koszt O(M(n * deg q) log n) zamiast O(n * M(n * deg q)) samego schematu Hornera.
+     */
+    template <class T>
+    vector<T> zloz(const T* w, size_t n, const vector<T>& q) {
+        vector<vector<T>> potegi{ q };
+        while ((size_t(1) << potegi.size()) < n) {
+            const vector<T>& p = potegi.back();
+            potegi.push_back(mnoz(p.data(), p.size(), p.data(), p.size()));
+        }
+        return zlozRekurencyjnie(w, n, q, potegi);
+    }
+}
+
+namespace detail {
+    /**
+     * Pula wektorów roboczych: rekurencja pobiera bufor i oddaje go po użyciu,
+     * więc kolejne poziomy korzystają z już zaalokowanej pamięci zamiast prosić o nową.
+     */
+    template <class F>
+    class PulaBuforow {
+    private:
+        vector<vector<F>> wolne;
+
+    public:
+        vector<F> pobierz() {
+            if (wolne.empty()) return {};
+            vector<F> v = move(wolne.back());
+            wolne.pop_back();
+            v.clear();
+            return v;
+        }
+
+        void oddaj(vector<F>&& v) { wolne.push_back(move(v)); }
+    };
+
+    /**
+     * Stopień wielomianu w konwencji NWD: wielomian zerowy to pusty wektor i ma stopień -1.
+     */
+    template <class F>
+    int stopienDokladny(const vector<F>& p) { return int(p.size()) - 1; }
+
+    template <class F>
+    void przytnijZera(vector<F>& p) {
+        while (!p.empty() && p.back() == F(0)) p.pop_back();
+    }
+
+    template <class F>
+    vector<F> iloczynDokladny(const vector<F>& a, const vector<F>& b) {
+        if (a.empty() || b.empty()) return {};
+        vector<F> wynik = mnoz(a.data(), a.size(), b.data(), b.size());
+        przytnijZera(wynik);
+        return wynik;
+    }
+
+    /**
+     * a + znak * b, z przycięciem zer wiodących (znak = 1 albo -1).
+     */
+    template <class F>
+    vector<F> sumaDokladna(vector<F> a, const vector<F>& b, int znak) {
+        if (a.size() < b.size()) a.resize(b.size(), F(0));
+        for (size_t i = 0; i < b.size(); ++i) a[i] = znak > 0 ? a[i] + b[i] : a[i] - b[i];
+        przytnijZera(a);
+        return a;
+    }
+
+    template <class F>
+    IlorazIReszta<F> dzielDokladnie(const vector<F>& a, const vector<F>& b) {
+        if (a.empty()) return {};
+        IlorazIReszta<F> wynik = dziel(a.data(), a.size(), b.data(), b.size());
+        przytnijZera(wynik.iloraz);
+        przytnijZera(wynik.reszta);
+        return wynik;
+    }
+
+    /**
+     * Macierz 2x2 wielomianów opisująca ciąg kroków Euklidesa: (c, d) = M * (a, b).
+     */
+    template <class F>
+    struct MacierzEuklidesa {
+        vector<F> m[2][2];
+
+        static MacierzEuklidesa jednostkowa() {
+            MacierzEuklidesa j;
+            j.m[0][0] = { F(1) };
+            j.m[1][1] = { F(1) };
+            return j;
+        }
+
+        MacierzEuklidesa operator*(const MacierzEuklidesa& o) const {
+            MacierzEuklidesa w;
+            for (int i = 0; i < 2; ++i)
+                for (int j = 0; j < 2; ++j)
+                    w.m[i][j] = sumaDokladna(iloczynDokladny(m[i][0], o.m[0][j]), iloczynDokladny(m[i][1], o.m[1][j]), 1);
+            return w;
+        }
+
+        /**
+         * Dokłada z lewej krok Euklidesa z ilorazem q: [[0, 1], [1, -q]] * M.
+         */
+        void krok(const vector<F>& q) {
+            vector<F> nowy0 = sumaDokladna(m[0][0], iloczynDokladny(q, m[1][0]), -1);
+            vector<F> nowy1 = sumaDokladna(m[0][1], iloczynDokladny(q, m[1][1]), -1);
+            m[0][0] = move(m[1][0]);
+            m[0][1] = move(m[1][1]);
+            m[1][0] = move(nowy0);
+            m[1][1] = move(nowy1);
+        }
+
+        pair<vector<F>, vector<F>> zastosuj(const vector<F>& a, const vector<F>& b) const {
+            return { sumaDokladna(iloczynDokladny(m[0][0], a), iloczynDokladny(m[0][1], b), 1),
+                     sumaDokladna(iloczynDokladny(m[1][0], a), iloczynDokladny(m[1][1], b), 1) };
+        }
+    };
+
+    inline size_t progPolNwd = 256;    // poniżej tego stopnia pół-NWD wykonuje zwykłe kroki Euklidesa
+    inline size_t progNwd = 2048;      // od tego stopnia NWD korzysta z pół-NWD (dobrane dla GF(p) z NTT; przy samej Karatsubie opłaca się dopiero ok. 32k)
+
+    /**
+     * Pół-NWD (half-GCD) dla dokładnych typów współczynników (ciało, np. GF(p)).
+     * Dla deg a > deg b zwraca macierz M kroków Euklidesa, po których (c, d) = M(a, b) ma deg d < ceil(deg a / 2).
+     * Pierwszą połowę kroków wyznacza rekurencyjnie z samych górnych współczynników (a div x^m, b div x^m),
+     * drugą — z górnych współczynników tego, co zostało; koszt O(M(n) log n).
+     * Obcięte kopie argumentów biorą pamięć z puli wspólnej dla wszystkich poziomów rekurencji.
+     */
+    template <class F>
+    MacierzEuklidesa<F> polNwd(const vector<F>& a, const vector<F>& b, PulaBuforow<F>& pula) {
+        int n = stopienDokladny(a);
+        int m = (n + 1) / 2;
+        if (stopienDokladny(b) < m) return MacierzEuklidesa<F>::jednostkowa();
+
+        auto przesun = [&](const vector<F>& p, int k) {
+            vector<F> wynik = pula.pobierz();
+            if (int(p.size()) > k) wynik.assign(p.begin() + k, p.end());
+            return wynik;
+        };
+
+        if (n < int(progPolNwd)) {
+            MacierzEuklidesa<F> mac = MacierzEuklidesa<F>::jednostkowa();
+            vector<F> c = a, d = b;
+            while (stopienDokladny(d) >= m) {
+                IlorazIReszta<F> qr = dzielDokladnie(c, d);
+                mac.krok(qr.iloraz);
+                c = move(d);
+                d = move(qr.reszta);
+            }
+            return mac;
+        }
+
+        vector<F> ga = przesun(a, m), gb = przesun(b, m);
+        MacierzEuklidesa<F> m1 = polNwd(ga, gb, pula);
+        pula.oddaj(move(ga));
+        pula.oddaj(move(gb));
+
+        auto [c, d] = m1.zastosuj(a, b);
+        if (stopienDokladny(d) < m) return m1;
+
+        IlorazIReszta<F> qr = dzielDokladnie(c, d);
+        m1.krok(qr.iloraz);
+        c = move(d);
+        d = move(qr.reszta);
+        if (stopienDokladny(d) < m) return m1;
+
+        int k = 2 * m - stopienDokladny(c);
+        vector<F> gc = przesun(c, k), gd = przesun(d, k);
+        MacierzEuklidesa<F> m2 = polNwd(gc, gd, pula);
+        pula.oddaj(move(gc));
+        pula.oddaj(move(gd));
+        return m2 * m1;
+    }
+
+    /**
+     * Unormowany (o wiodącym współczynniku 1) NWD dwóch wielomianów nad ciałem dokładnym.
+     * Duże stopnie redukuje pół-NWD, końcówkę zwykły Euklides. Każda macierz M ma wyznacznik +-1,
+     * więc NWD(M(a, b)) = NWD(a, b) niezależnie od tego, jak daleko pół-NWD zdołało zejść.
+     */
+    template <class F>
+    vector<F> nwdDokladny(vector<F> a, vector<F> b) {
+        przytnijZera(a);
+        przytnijZera(b);
+        if (a.size() < b.size()) swap(a, b);
+
+        PulaBuforow<F> pula;
+        while (!b.empty()) {
+            if (stopienDokladny(a) >= int(progNwd) && a.size() > b.size()) {
+                tie(a, b) = polNwd(a, b, pula).zastosuj(a, b);
+                if (b.empty()) break;
+            }
+            IlorazIReszta<F> qr = dzielDokladnie(a, b);
+            a = move(b);
+            b = move(qr.reszta);
+        }
+
+        if (!a.empty()) {
+            F odwrotnosc = F(1) / a.back();
+            for (F& c : a) c = c * odwrotnosc;
+        }
+        return a;
+    }
+
+    template <class T>
+    T sprzezenie(const T& x) {
+        if constexpr (jestZespolony<T>::value) return conj(x);
+        else return x;
+    }
+
+    /**
+     * Rozkład QR Householdera macierzy w x k zapisanej kolumnami (a[j * w + i]). Rozkładamy pierwsze
+     * `rozkladane` kolumny, a odbicia stosujemy też do pozostałych (np. prawej strony układu). Przy `wybor`
+     * kolejną kolumną jest ta o największej normie reszty, co ujawnia rząd numeryczny na przekątnej R;
+     * `kolumny[j]` to wtedy pierwotny numer j-tej kolumny. Po powrocie R leży nad przekątną tablicy.
+     */
+    template <class T>
+    void rozkladQR(vector<T>& a, size_t w, size_t k, size_t rozkladane, bool wybor, vector<size_t>& kolumny) {
+        using Skalar = decltype(abs(T{}));
+        kolumny.resize(k);
+        iota(kolumny.begin(), kolumny.end(), size_t(0));
+        auto normaKwadrat = [&](size_t j, size_t od) {
+            Skalar s = 0;
+            for (size_t i = od; i < w; ++i) s += norm(a[j * w + i]);
+            return s;
+        };
+
+        for (size_t r = 0; r < min(w, rozkladane); ++r) {
+            if (wybor) {
+                size_t p = r;
+                Skalar najwieksza = normaKwadrat(r, r);
+                for (size_t j = r + 1; j < rozkladane; ++j) {
+                    Skalar s = normaKwadrat(j, r);
+                    if (s > najwieksza) najwieksza = s, p = j;
+                }
+                if (p != r) {
+                    swap_ranges(a.begin() + r * w, a.begin() + (r + 1) * w, a.begin() + p * w);
+                    swap(kolumny[r], kolumny[p]);
+                }
+            }
+
+            T* x = a.data() + r * w;
+            Skalar dlugosc = sqrt(normaKwadrat(r, r));
+            if (dlugosc == 0) continue;
+            T faza = abs(x[r]) == 0 ? T(1) : x[r] / abs(x[r]);
+            T alfa = -faza * dlugosc;
+            x[r] -= alfa;
+            Skalar v2 = normaKwadrat(r, r);
+            for (size_t j = r + 1; j < k; ++j) {
+                T* y = a.data() + j * w;
+                T s = 0;
+                for (size_t i = r; i < w; ++i) s += sprzezenie(x[i]) * y[i];
+                s *= T(2) / v2;
+                for (size_t i = r; i < w; ++i) y[i] -= s * x[i];
+            }
+            x[r] = alfa;
+            fill(x + r + 1, x + w, T(0));
+        }
+    }
+
+    /**
+     * Macierz Sylvestera [C(a) | C(b)] o `ka` przesunięciach a i `kb` przesunięciach b, zapisana kolumnami do bufora s.
+     * Wektor (v, -u) z jej jądra spełnia a * v = b * u.
+     */
+    template <class T>
+    void macierzSylvestera(const vector<T>& a, size_t ka, const vector<T>& b, size_t kb, size_t w, vector<T>& s) {
+        s.assign((ka + kb) * w, T(0));
+        for (size_t j = 0; j < ka; ++j) copy(a.begin(), a.end(), s.begin() + j * w + j);
+        for (size_t j = 0; j < kb; ++j) copy(b.begin(), b.end(), s.begin() + (ka + j) * w + j);
+    }
+
+    /**
+     * Największa suma stopni, dla której nwdPrzyblizony liczy przez macierz Sylvestera: koszt rośnie jak
+     * (deg a + deg b)^3, a pamięć jak (deg a + deg b)^2 (na progu to ok. 1 s i 5 MB dla double).
+     */
+    inline size_t progNwdSylvestera = 768;
+
+    /**
+     * Algorytm Euklidesa z tolerancją dla wejść przeskalowanych do normy 1: współczynnik reszty uznajemy za zero,
+     * gdy |c| <= tolerancja * max|dzielnik|. Dzielenie odbywa się w miejscu w buforze dzielnej, a bufory a, b
+     * zamieniają się rolami, więc pętla nie alokuje. Reszty w arytmetyce przybliżonej szybko tracą wspólny czynnik
+     * (przy losowych danych już od stopnia ok. 20), dlatego to tylko ścieżka dla stopni powyżej progNwdSylvestera.
+     */
+    template <class T>
+    vector<T> nwdEuklides(vector<T> a, vector<T> b, decltype(abs(T{})) tolerancja) {
+        using Skalar = decltype(abs(T{}));
+        auto normaMax = [](const vector<T>& p) {
+            Skalar m = 0;
+            for (const T& c : p) m = max(m, Skalar(abs(c)));
+            return m;
+        };
+
+        if (a.size() < b.size()) swap(a, b);
+        while (!b.empty()) {
+            Skalar prog = tolerancja * normaMax(b);
+            size_t n = a.size(), m = b.size();
+            for (size_t k = n - m + 1; k-- > 0;) {
+                T c = a[k + m - 1] / b[m - 1];
+                for (size_t j = 0; j < m; ++j) a[k + j] -= c * b[j];
+            }
+            a.resize(m - 1);
+            while (!a.empty() && abs(a.back()) <= prog) a.pop_back();
+
+            Skalar norma = normaMax(a);
+            for (T& c : a) c /= norma;
+            swap(a, b);
+        }
+
+        T wiodacy = a.back();
+        for (T& c : a) c /= wiodacy;
+        return a;
+    }
+
+    /**
+     * Bufory rozkładów QR w nwdSylvester, osobne dla każdego wątku i używane ponownie przy kolejnych wywołaniach.
+     */
+    template <class T>
+    struct ObszarNwd {
+        vector<T> macierz, uklad, wektor, jadro;
+        vector<size_t> kolumny;
+    };
+
+    /**
+     * NWD w arytmetyce przybliżonej przez macierz Sylvestera, bo reszty algorytmu Euklidesa tracą wspólny
+     * czynnik już przy stopniach rzędu 20. Wejścia skalujemy do normy 1; stopień k NWD to liczba elementów
+     * przekątnej R (z QR z wyborem kolumn macierzy S_0) nie większych niż tolerancja * |R_00|. Jądro k-tej
+     * podrezultanty S_k daje kofaktory u, v (a = g u, b = g v), a samo g to rozwiązanie najmniejszych
+     * kwadratów układu [C(u); C(v)] g = [a; b]. Koszt O((deg a + deg b)^3) czasu i O((deg a + deg b)^2) pamięci
+     * w buforach wątku; powyżej progNwdSylvestera liczymy zwykłym Euklidesem (nwdEuklides). Tolerancję podnosimy
+     * co najmniej do 64 epsilonów typu. Wynik jest unormowany (wiodący współczynnik 1).
+     */
+    template <class T>
+    vector<T> nwdSylvester(vector<T> a, vector<T> b, decltype(abs(T{})) tolerancja) {
+        using Skalar = decltype(abs(T{}));
+        tolerancja = max(tolerancja, 64 * numeric_limits<Skalar>::epsilon());
+        auto normuj = [](vector<T>& p) {
+            Skalar s = 0;
+            for (const T& c : p) s += norm(c);
+            s = sqrt(s);
+            if (s > 0) for (T& c : p) c /= s;
+        };
+        auto przytnij = [&](vector<T>& p) {
+            normuj(p);
+            while (!p.empty() && abs(p.back()) <= tolerancja) p.pop_back();
+        };
+        auto unormowany = [](vector<T> p) {
+            T wiodacy = p.back();
+            for (T& c : p) c /= wiodacy;
+            return p;
+        };
+
+        przytnij(a);
+        przytnij(b);
+        if (a.empty() && b.empty()) return { T(0) };
+        if (a.empty()) return unormowany(move(b));
+        if (b.empty()) return unormowany(move(a));
+        size_t n = a.size() - 1, m = b.size() - 1;
+        if (n == 0 || m == 0) return { T(1) };
+        if (n + m > progNwdSylvestera) return nwdEuklides(move(a), move(b), tolerancja);
+
+        static thread_local ObszarNwd<T> obszar;
+        vector<T>& s = obszar.macierz;
+        vector<size_t>& kolumny = obszar.kolumny;
+        macierzSylvestera(a, m, b, n, n + m, s);
+        rozkladQR(s, n + m, n + m, n + m, true, kolumny);
+        Skalar prog = tolerancja * abs(s[0]);
+        size_t k = 0;
+        for (size_t r = 0; r < n + m; ++r) k += abs(s[r * (n + m) + r]) <= prog;
+        k = min(k, min(n, m));
+        if (k == 0) return { T(1) };
+
+        size_t w = n + m - k + 1, c = n + m - 2 * k + 2;
+        macierzSylvestera(a, m - k + 1, b, n - k + 1, w, s);
+        rozkladQR(s, w, c, c, true, kolumny);
+        vector<T>& y = obszar.wektor;
+        y.assign(c, T(0));
+        y[c - 1] = T(1);
+        for (size_t r = c - 1; r-- > 0;) {
+            T suma = s[(c - 1) * w + r];
+            for (size_t j = r + 1; j < c - 1; ++j) suma += s[j * w + r] * y[j];
+            T d = s[r * w + r];
+            y[r] = abs(d) == 0 ? T(0) : -suma / d;
+        }
+        // jądro w pierwotnej kolejności kolumn: v to pierwsze m - k + 1 składowych, -u — pozostałe
+        vector<T>& jadro = obszar.jadro;
+        jadro.resize(c);
+        for (size_t j = 0; j < c; ++j) jadro[kolumny[j]] = y[j];
+
+        size_t wg = n + m + 2;
+        vector<T>& g = obszar.uklad;
+        g.assign((k + 2) * wg, T(0));
+        for (size_t j = 0; j <= k; ++j) {
+            for (size_t i = 0; i <= n - k; ++i) g[j * wg + j + i] = -jadro[m - k + 1 + i];
+            for (size_t i = 0; i <= m - k; ++i) g[j * wg + n + 1 + j + i] = jadro[i];
+        }
+        copy(a.begin(), a.end(), g.begin() + (k + 1) * wg);
+        copy(b.begin(), b.end(), g.begin() + (k + 1) * wg + n + 1);
+        rozkladQR(g, wg, k + 2, k + 1, false, kolumny);
+        vector<T> wynik(k + 1, T(0));
+        for (size_t r = k + 1; r-- > 0;) {
+            T suma = g[(k + 1) * wg + r];
+            for (size_t j = r + 1; j <= k; ++j) suma -= g[j * wg + r] * wynik[j];
+            wynik[r] = suma / g[r * wg + r];
+        }
+        return unormowany(move(wynik));
+    }
+
+    template <class T>
+    using WyrazRzadki = pair<size_t, T>;
+
+    /**
+     * x^k przez podnoszenie do kwadratu.
+     */
+    template <class T>
+    T potega(T x, size_t k) {
+        T wynik = T(1);
+        for (; k; k >>= 1, x *= x)
+            if (k & 1) wynik *= x;
+        return wynik;
+    }
+
+    /**
+     * Horner po wyrazach rzadkich: przeskok między kolejnymi wykładnikami to jedno mnożenie przez x^luka.
+     */
+    template <class T>
+    T wartoscRzadka(const vector<WyrazRzadki<T>>& w, T x) {
+        if (w.empty()) return T(0);
+        T wynik = T(0);
+        size_t poprzedni = w.back().first;
+        for (size_t k = w.size(); k-- > 0;) {
+            wynik = wynik * potega(x, poprzedni - w[k].first) + w[k].second;
+            poprzedni = w[k].first;
+        }
+        return wynik * potega(x, poprzedni);
+    }
+
+    /**
+     * out[i] += in[i] dla i < n (out może pokrywać się z in).
+     */
+    template <class T>
+    inline void dodajWektorySkalarnie(T* out, const T* in, size_t n) {
+        for (size_t i = 0; i < n; ++i) out[i] += in[i];
+    }
+
+#ifdef WIELOMIAN_X86_SIMD
+    __attribute__((target("avx2")))
+    inline void dodajWektoryAVX2(double* out, const double* in, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256d a = _mm256_add_pd(_mm256_loadu_pd(out + i), _mm256_loadu_pd(in + i));
+            __m256d b = _mm256_add_pd(_mm256_loadu_pd(out + i + 4), _mm256_loadu_pd(in + i + 4));
+            _mm256_storeu_pd(out + i, a);
+            _mm256_storeu_pd(out + i + 4, b);
+        }
+        dodajWektorySkalarnie(out + i, in + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    inline void dodajWektoryAVX2(float* out, const float* in, size_t n) {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m256 a = _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_loadu_ps(in + i));
+            __m256 b = _mm256_add_ps(_mm256_loadu_ps(out + i + 8), _mm256_loadu_ps(in + i + 8));
+            _mm256_storeu_ps(out + i, a);
+            _mm256_storeu_ps(out + i + 8, b);
+        }
+        dodajWektorySkalarnie(out + i, in + i, n - i);
+    }
+
+    __attribute__((target("avx2")))
+    inline void dodajWektoryAVX2(int64_t* out, const int64_t* in, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i a = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(out + i)), _mm256_loadu_si256((const __m256i*)(in + i)));
+            __m256i b = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(out + i + 4)), _mm256_loadu_si256((const __m256i*)(in + i + 4)));
+            _mm256_storeu_si256((__m256i*)(out + i), a);
+            _mm256_storeu_si256((__m256i*)(out + i + 4), b);
+        }
+        dodajWektorySkalarnie(out + i, in + i, n - i);
+    }
+#endif
+
+    template <class T>
+    using FunkcjaDodawania = void (*)(T*, const T*, size_t);
+
+    template <class T>
+    inline FunkcjaDodawania<T> wybierzDodawanie() {
+#ifdef WIELOMIAN_X86_SIMD
+        if constexpr (is_same_v<T, double> || is_same_v<T, float> || is_same_v<T, int64_t>) {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return static_cast<FunkcjaDodawania<T>>(dodajWektoryAVX2);
+        }
+#endif
+        return dodajWektorySkalarnie<T>;
+    }
+
+    /**
+     * Wektorowe out[i] += in[i]; liczby zespolone dodawane są jako tablica 2n części (układ gwarantowany przez standard).
+     */
+    template <class T>
+    inline void dodajWektory(T* out, const T* in, size_t n) {
+        if constexpr (jestZespolony<T>::value) {
+            using R = typename T::value_type;
+            dodajWektory(reinterpret_cast<R*>(out), reinterpret_cast<const R*>(in), 2 * n);
+        }
+        else {
+            static const FunkcjaDodawania<T> dodaj = wybierzDodawanie<T>();
+            dodaj(out, in, n);
+        }
+    }
+
+    /**
+     * Scala dwie posortowane listy wyrazów: a + znak * b, bez zerowych wyników.
+     */
+    template <class T>
+    vector<WyrazRzadki<T>> dodajRzadkie(const vector<WyrazRzadki<T>>& a, const vector<WyrazRzadki<T>>& b, T znak) {
+        vector<WyrazRzadki<T>> wynik;
+        wynik.reserve(a.size() + b.size());
+        size_t i = 0, j = 0;
+        while (i < a.size() || j < b.size()) {
+            if (j == b.size() || (i < a.size() && a[i].first < b[j].first)) wynik.push_back(a[i++]);
+            else if (i == a.size() || b[j].first < a[i].first) wynik.emplace_back(b[j].first, znak * b[j].second), ++j;
+            else {
+                T c = a[i].second + znak * b[j].second;
+                if (c != T(0)) wynik.emplace_back(a[i].first, c);
+                ++i, ++j;
+            }
+        }
+        return wynik;
+    }
+
+    /**
+     * Iloczyn dwóch wielomianów rzadkich metodą Johnsona: kopiec trzyma po jednym kandydacie a[i]*b[j]
+     * dla każdego wyrazu krótszego czynnika, więc wyrazy wyniku powstają od razu posortowane,
+     * w czasie O(ta * tb * log(min(ta, tb))) i pamięci O(min(ta, tb)) poza samym wynikiem.
+     */
+    template <class T>
+    vector<WyrazRzadki<T>> mnozRzadkie(const vector<WyrazRzadki<T>>& a, const vector<WyrazRzadki<T>>& b) {
+        if (a.size() > b.size()) return mnozRzadkie(b, a);
+        vector<WyrazRzadki<T>> wynik;
+        if (a.empty()) return wynik;
+
+        using Kandydat = tuple<size_t, size_t, size_t>;     // (wykładnik, i, j)
+        priority_queue<Kandydat, vector<Kandydat>, greater<Kandydat>> kopiec;
+        for (size_t i = 0; i < a.size(); ++i) kopiec.emplace(a[i].first + b[0].first, i, 0);
+
+        while (!kopiec.empty()) {
+            auto [wykladnik, i, j] = kopiec.top();
+            kopiec.pop();
+            T c = a[i].second * b[j].second;
+            if (!wynik.empty() && wynik.back().first == wykladnik) wynik.back().second += c;
+            else {
+                if (!wynik.empty() && wynik.back().second == T(0)) wynik.pop_back();
+                wynik.emplace_back(wykladnik, c);
+            }
+            if (j + 1 < b.size()) kopiec.emplace(a[i].first + b[j + 1].first, i, j + 1);
+        }
+        if (!wynik.empty() && wynik.back().second == T(0)) wynik.pop_back();
+        return wynik;
+    }
+}
+
+namespace detail {
+    inline size_t progMillera = 8;     // najwięcej niezerowych wyrazów (poza wolnym), przy których opłaca się rekurencja Millera
+
+    /**
+     * cel = a * b; krótkie czynniki mnożone są szkolnie w buforze cel, który zachowuje pojemność między wywołaniami.
+     */
+    template <class T>
+    void mnozDo(vector<T>& cel, const vector<T>& a, const vector<T>& b) {
+        if (min(a.size(), b.size()) >= ProgiMnozenia::karatsuba) {
+            cel = mnoz(a.data(), a.size(), b.data(), b.size());
+            return;
+        }
+        cel.assign(a.size() + b.size() - 1, T(0));
+        mnozNaiwnie(a.data(), a.size(), b.data(), b.size(), cel.data());
+    }
+
+    /**
+     * w^e szybkim potęgowaniem od najstarszego bitu wykładnika: kwadrat wyniku, potem ewentualnie mnożenie
+     * przez krótką podstawę. Dwa bufory wymieniają się rolami, więc pamięć nie jest przydzielana na każdy krok.
+     */
+    template <class T>
+    vector<T> potegaBinarna(const T* w, size_t n, unsigned e) {
+        if (e == 0) return { T(1) };
+        vector<T> podstawa(w, w + n), wynik = podstawa, pomocniczy;
+        wynik.reserve((n - 1) * e + 1);
+        pomocniczy.reserve((n - 1) * e + 1);
+        for (int b = bit_width(e) - 2; b >= 0; --b) {
+            mnozDo(pomocniczy, wynik, wynik);
+            swap(wynik, pomocniczy);
+            if ((e >> b) & 1) {
+                mnozDo(pomocniczy, wynik, podstawa);
+                swap(wynik, pomocniczy);
+            }
+        }
+        return wynik;
+    }
+
+    /**
+     * w^e rekurencją J.C.P. Millera w czasie O(e * d * t) (d — stopień, t — liczba niezerowych współczynników w):
+     * z q = w^e mamy w * q' = e * w' * q, skąd q_0 = w_0^e oraz
+     * q_k = 1 / (k * w_0) * sum_{j=1..min(k,d)} ((e + 1) * j - k) * w_j * q_{k-j}.
+     * Wymaga w_0 != 0 i dokładnej arytmetyki: liczb całkowitych (suma w __int128, dzielenie jest wtedy dokładne)
+     * albo GF(p) z d * e < p. W liczbach zmiennoprzecinkowych rekurencja jest niestabilna — nawet przy dominującym
+     * w_0 błąd rośnie z e do rzędu samych współczynników.
+     */
+    template <class T>
+    vector<T> potegaMillera(const T* w, size_t n, unsigned e) {
+        using Suma = conditional_t<is_integral_v<T>, __int128, T>;
+        size_t d = n - 1, dlugosc = d * e + 1;
+        // suma rozbita na sum (e + 1) * j * w_j * q_{k-j} - k * sum w_j * q_{k-j}
+        vector<size_t> niezerowe;
+        vector<Suma> wj, ej;
+        for (size_t j = 1; j <= d; ++j)
+            if (w[j] != T(0)) {
+                niezerowe.push_back(j);
+                wj.push_back(Suma(w[j]));
+                ej.push_back(Suma((long long)(e + 1) * (long long)j) * Suma(w[j]));
+            }
+
+        // w ciele: odwr[k] = 1 / (k * w_0) z jednym odwracaniem (iloczyny prefiksowe)
+        vector<T> odwr;
+        if constexpr (!is_integral_v<T>) {
+            odwr.resize(dlugosc);
+            T iloczyn = T(1);
+            for (size_t k = 1; k < dlugosc; ++k) {
+                odwr[k] = iloczyn;
+                iloczyn *= T((long long)k);
+            }
+            T r = T(1) / (iloczyn * w[0]);
+            for (size_t k = dlugosc; k-- > 1;) {
+                odwr[k] *= r;
+                r *= T((long long)k);
+            }
+        }
+
+        vector<T> q(dlugosc, T(0));
+        q[0] = potega(w[0], e);
+        for (size_t k = 1; k < dlugosc; ++k) {
+            Suma s1 = Suma(0), s2 = Suma(0);
+            for (size_t t = 0; t < niezerowe.size() && niezerowe[t] <= k; ++t) {
+                Suma qk = Suma(q[k - niezerowe[t]]);
+                s1 += ej[t] * qk;
+                s2 += wj[t] * qk;
+            }
+            Suma s = s1 - Suma((long long)k) * s2;
+            if constexpr (is_integral_v<T>) q[k] = T(s / (Suma((long long)k) * Suma(w[0])));
+            else q[k] = s * odwr[k];
+        }
+        return q;
+    }
+
+    /**
+     * Czy potęgę w^e (w_0 != 0) liczyć rekurencją Millera: kosztuje ona ok. 2t mnożeń na współczynnik wyniku,
+     * a potęgowanie binarne jest tańsze, dopóki ostatnie podnoszenie do kwadratu nie wychodzi poza mnożenie
+     * szkolne i Karatsubę. Granice dobrane według benchmarkPotegowania.
+     */
+    template <class T>
+    bool oplacaSieMiller(const T* w, size_t n, unsigned e) {
+        size_t t = size_t(count_if(w + 1, w + n, [](const T& c) { return c != T(0); }));
+        return e >= 2 && t >= 1 && t <= progMillera && ((n - 1) * e + 1) / 2 >= ProgiMnozenia::ntt;
+    }
+}
+
+/**
+ * Przybliżony pierwiastek zespolony wraz z oszacowaniem błędu: w kole o środku wartosc i promieniu blad
+ * leży pierwiastek wielomianu (promień z włączenia Newtona, n * |p(z) / p'(z)|). zbiezny mówi, czy |p(z)|
+ * spadło do poziomu błędów zaokrągleń, zanim skończył się limit iteracji.
+ */
+struct Pierwiastek {
+    complex<double> wartosc;
+    double blad;
+    bool zbiezny;
+};
+
+namespace detail {
+    /**
+     * Stała pula wątków wykonująca zadania 0..n-1 jednego wywołania rownolegle() (równoległa pętla for).
+     * Wątek wywołujący też pracuje, więc pula o rozmiarze 1 nie tworzy żadnego wątku.
+     * Zadania nie mogą rzucać wyjątków ani same wołać rownolegle() na tej samej puli.
+     */
+    class PulaWatkow {
+    private:
+        vector<thread> watki;
+        mutex wylacznosc;                   // jedno wywołanie rownolegle() naraz
+        mutex blokada;
+        condition_variable start, koniec;
+        const function<void(size_t)>* zadanie = nullptr;
+        size_t ileZadan = 0;
+        atomic<size_t> nastepne{ 0 };
+        size_t pracujacych = 0;
+        size_t pokolenie = 0;
+        bool zamykanie = false;
+
+        void wykonujZadania() {
+            for (size_t i; (i = nastepne.fetch_add(1, memory_order_relaxed)) < ileZadan;) (*zadanie)(i);
+        }
+
+        void petla() {
+            size_t widziane = 0;
+            unique_lock<mutex> lk(blokada);
+            while (true) {
+                start.wait(lk, [&] { return zamykanie || pokolenie != widziane; });
+                if (zamykanie) return;
+                widziane = pokolenie;
+                lk.unlock();
+                wykonujZadania();
+                lk.lock();
+                if (--pracujacych == 0) koniec.notify_one();
+            }
+        }
+
+    public:
+        explicit PulaWatkow(size_t ileWatkow) {
+            for (size_t i = 1; i < ileWatkow; ++i) watki.emplace_back([this] { petla(); });
+        }
+
+        ~PulaWatkow() {
+            {
+                lock_guard<mutex> lk(blokada);
+                zamykanie = true;
+            }
+            start.notify_all();
+            for (thread& w : watki) w.join();
+        }
+
+        PulaWatkow(const PulaWatkow&) = delete;
+        PulaWatkow& operator=(const PulaWatkow&) = delete;
+
+        size_t rozmiar() const { return watki.size() + 1; }
+
+        void rownolegle(size_t n, const function<void(size_t)>& f) {
+            if (watki.empty() || n <= 1) {
+                for (size_t i = 0; i < n; ++i) f(i);
+                return;
+            }
+            lock_guard<mutex> jeden(wylacznosc);
+            {
+                lock_guard<mutex> lk(blokada);
+                zadanie = &f;
+                ileZadan = n;
+                nastepne.store(0, memory_order_relaxed);
+                pracujacych = watki.size();
+                ++pokolenie;
+            }
+            start.notify_all();
+            wykonujZadania();
+            unique_lock<mutex> lk(blokada);
+            koniec.wait(lk, [&] { return pracujacych == 0; });
+        }
+
+        /**
+         * Wspólna pula o rozmiarze równym liczbie wątków sprzętowych.
+         */
+        static PulaWatkow& globalna() {
+            static PulaWatkow pula(max<size_t>(thread::hardware_concurrency(), 1));
+            return pula;
+        }
+    };
+
+    /**
+     * Zadania uruchomione razem, na których zakończenie czeka PulaZadan::czekaj. Pierwszy wyjątek z zadań
+     * jest przechowywany i rzucany ponownie w czekaj.
+     */
+    class GrupaZadan {
+    private:
+        friend class PulaZadan;
+        atomic<size_t> pozostale{ 0 };
+        mutex blokada;
+        exception_ptr blad;
+
+        void zapiszBlad(exception_ptr e) {
+            lock_guard<mutex> lk(blokada);
+            if (!blad) blad = e;
+        }
+    };
+
+    /**
+     * Pula wątków z kradzieżą zadań dla rekurencji typu fork-join (w odróżnieniu od PulaWatkow zadania mogą
+     * uruchamiać kolejne). Każdy wątek ma własną kolejkę: nowe zadania odkłada na jej koniec i stamtąd je bierze
+     * (najświeższe, najmniejsze poddrzewa), a bezczynny wątek kradnie z początku cudzej kolejki (najstarsze, największe).
+     * Wątek czekający na grupę nie usypia, tylko wykonuje w tym czasie inne zadania, więc zagnieżdżone czekanie
+     * nie blokuje puli. Kolejka 0 należy do wątków spoza puli; pula o rozmiarze 1 wykonuje wszystko w czekaj.
+     */
+    class PulaZadan {
+    private:
+        struct Kolejka {
+            mutex blokada;
+            deque<function<void()>> zadania;
+        };
+
+        vector<unique_ptr<Kolejka>> kolejki;
+        vector<thread> watki;
+        atomic<size_t> oczekujace{ 0 };
+        mutex blokada;
+        condition_variable sygnal;
+        bool zamykanie = false;
+
+        static inline thread_local const PulaZadan* pulaWatku = nullptr;
+        static inline thread_local size_t numerWatku = 0;
+
+        size_t wlasnaKolejka() const { return pulaWatku == this ? numerWatku : 0; }
+
+        bool wykonajJedno() {
+            size_t wlasna = wlasnaKolejka(), n = kolejki.size();
+            for (size_t k = 0; k < n; ++k) {
+                Kolejka& q = *kolejki[(wlasna + k) % n];
+                function<void()> zadanie;
+                {
+                    lock_guard<mutex> lk(q.blokada);
+                    if (q.zadania.empty()) continue;
+                    if (k == 0) {
+                        zadanie = move(q.zadania.back());
+                        q.zadania.pop_back();
+                    }
+                    else {
+                        zadanie = move(q.zadania.front());
+                        q.zadania.pop_front();
+                    }
+                }
+                oczekujace.fetch_sub(1, memory_order_relaxed);
+                zadanie();
+                return true;
+            }
+            return false;
+        }
+
+        void petla(size_t numer) {
+            pulaWatku = this;
+            numerWatku = numer;
+            while (true) {
+                if (wykonajJedno()) continue;
+                unique_lock<mutex> lk(blokada);
+                sygnal.wait(lk, [&] { return zamykanie || oczekujace.load(memory_order_relaxed) > 0; });
+                if (zamykanie) return;
+            }
+        }
+
+    public:
+        explicit PulaZadan(size_t ileWatkow) {
+            for (size_t i = 0; i < max<size_t>(ileWatkow, 1); ++i) kolejki.push_back(make_unique<Kolejka>());
+            for (size_t i = 1; i < kolejki.size(); ++i) watki.emplace_back([this, i] { petla(i); });
+        }
+
+        ~PulaZadan() {
+            {
+                lock_guard<mutex> lk(blokada);
+                zamykanie = true;
+            }
+            sygnal.notify_all();
+            for (thread& w : watki) w.join();
+        }
+
+        PulaZadan(const PulaZadan&) = delete;
+        PulaZadan& operator=(const PulaZadan&) = delete;
+
+        size_t rozmiar() const { return kolejki.size(); }
+
+        /**
+         * Odkłada zadanie f do wykonania w ramach grupy g (g musi żyć do końca czekaj(g)).
+         */
+        template <class F>
+        void uruchom(GrupaZadan& g, F f) {
+            g.pozostale.fetch_add(1, memory_order_relaxed);
+            Kolejka& q = *kolejki[wlasnaKolejka()];
+            {
+                lock_guard<mutex> lk(q.blokada);
+                q.zadania.emplace_back([&g, f = move(f)]() mutable {
+                    try { f(); }
+                    catch (...) { g.zapiszBlad(current_exception()); }
+                    g.pozostale.fetch_sub(1, memory_order_release);
+                });
+            }
+            oczekujace.fetch_add(1, memory_order_relaxed);
+            { lock_guard<mutex> lk(blokada); }
+            sygnal.notify_one();
+        }
+
+        /**
+         * Czeka na wszystkie zadania grupy, wykonując w tym czasie zadania z kolejek; rzuca pierwszy wyjątek z grupy.
+         */
+        void czekaj(GrupaZadan& g) {
+            while (g.pozostale.load(memory_order_acquire) > 0)
+                if (!wykonajJedno()) this_thread::yield();
+            if (g.blad) rethrow_exception(g.blad);
+        }
+
+        /**
+         * Wspólna pula o rozmiarze równym liczbie wątków sprzętowych.
+         */
+        static PulaZadan& globalna() {
+            static PulaZadan pula(max<size_t>(thread::hardware_concurrency(), 1));
+            return pula;
+        }
+    };
+
+    /**
+     * Punkty zespolone (re, im osobno) i miejsca na wyniki Hornera z pochodną:
+     * p = w(u), d = w'(u) oraz skala = suma |w_i| |u|^i (do oceny błędu zaokrągleń p).
+     */
+    struct PunktyHornera {
+        const double* re;
+        const double* im;
+        double* pRe;
+        double* pIm;
+        double* dRe;
+        double* dIm;
+        double* skala;
+    };
+
+    /**
+     * Zespolony Horner liczący jednocześnie wartość, pochodną i skalę, punkt po punkcie.
+     */
+    inline void hornerZespolonySkalarnie(const double* w, const double* wAbs, size_t n, PunktyHornera pt, size_t od, size_t ile) {
+        for (size_t p = od; p < ile; ++p) {
+            double ur = pt.re[p], ui = pt.im[p], um = hypot(ur, ui);
+            double pr = w[n - 1], pi = 0, dr = 0, di = 0, s = wAbs[n - 1];
+            for (size_t i = n - 1; i-- > 0;) {
+                double ndr = dr * ur - di * ui + pr, ndi = dr * ui + di * ur + pi;
+                double npr = pr * ur - pi * ui + w[i], npi = pr * ui + pi * ur;
+                dr = ndr; di = ndi; pr = npr; pi = npi;
+                s = s * um + wAbs[i];
+            }
+            pt.pRe[p] = pr; pt.pIm[p] = pi; pt.dRe[p] = dr; pt.dIm[p] = di; pt.skala[p] = s;
+        }
+    }
+
+    /**
+     * Suma 1 / (x - z_j) po j z [od, do), bez rozkazów wektorowych.
+     */
+    inline complex<double> sumaOdwrotnosciSkalarnie(const double* zr, const double* zi, size_t od, size_t doo, double xr, double xi) {
+        double sr = 0, si = 0;
+        for (size_t j = od; j < doo; ++j) {
+            double dx = xr - zr[j], dy = xi - zi[j], q = 1 / (dx * dx + dy * dy);
+            sr += dx * q;
+            si -= dy * q;
+        }
+        return { sr, si };
+    }
+
+#ifdef WIELOMIAN_X86_SIMD
+    /**
+     * Zespolony Horner z pochodną na AVX2 + FMA, cztery punkty na wektor.
+     */
+    __attribute__((target("avx2,fma")))
+    inline void hornerZespolonyAVX2(const double* w, const double* wAbs, size_t n, PunktyHornera pt, size_t od, size_t ile) {
+        size_t p = od;
+        for (; p + 4 <= ile; p += 4) {
+            __m256d ur = _mm256_loadu_pd(pt.re + p), ui = _mm256_loadu_pd(pt.im + p);
+            __m256d um = _mm256_sqrt_pd(_mm256_fmadd_pd(ur, ur, _mm256_mul_pd(ui, ui)));
+            __m256d pr = _mm256_broadcast_sd(w + n - 1), pi = _mm256_setzero_pd();
+            __m256d dr = pi, di = pi, s = _mm256_broadcast_sd(wAbs + n - 1);
+            for (size_t i = n - 1; i-- > 0;) {
+                __m256d ndr = _mm256_fmadd_pd(dr, ur, _mm256_fnmadd_pd(di, ui, pr));
+                __m256d ndi = _mm256_fmadd_pd(dr, ui, _mm256_fmadd_pd(di, ur, pi));
+                __m256d npr = _mm256_fmadd_pd(pr, ur, _mm256_fnmadd_pd(pi, ui, _mm256_broadcast_sd(w + i)));
+                __m256d npi = _mm256_fmadd_pd(pr, ui, _mm256_mul_pd(pi, ur));
+                dr = ndr; di = ndi; pr = npr; pi = npi;
+                s = _mm256_fmadd_pd(s, um, _mm256_broadcast_sd(wAbs + i));
+            }
+            _mm256_storeu_pd(pt.pRe + p, pr); _mm256_storeu_pd(pt.pIm + p, pi);
+            _mm256_storeu_pd(pt.dRe + p, dr); _mm256_storeu_pd(pt.dIm + p, di);
+            _mm256_storeu_pd(pt.skala + p, s);
+        }
+        hornerZespolonySkalarnie(w, wAbs, n, pt, p, ile);
+    }
+
+    /**
+     * Suma 1 / (x - z_j) na AVX2 + FMA, cztery j naraz.
+     */
+    __attribute__((target("avx2,fma")))
+    inline complex<double> sumaOdwrotnosciAVX2(const double* zr, const double* zi, size_t od, size_t doo, double xr, double xi) {
+        __m256d vxr = _mm256_set1_pd(xr), vxi = _mm256_set1_pd(xi), jeden = _mm256_set1_pd(1.0);
+        __m256d sr = _mm256_setzero_pd(), si = sr;
+        size_t j = od;
+        for (; j + 4 <= doo; j += 4) {
+            __m256d dx = _mm256_sub_pd(vxr, _mm256_loadu_pd(zr + j)), dy = _mm256_sub_pd(vxi, _mm256_loadu_pd(zi + j));
+            __m256d q = _mm256_div_pd(jeden, _mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy)));
+            sr = _mm256_fmadd_pd(dx, q, sr);
+            si = _mm256_fnmadd_pd(dy, q, si);
+        }
+        alignas(32) double r[4], i[4];
+        _mm256_store_pd(r, sr);
+        _mm256_store_pd(i, si);
+        return complex<double>(r[0] + r[1] + r[2] + r[3], i[0] + i[1] + i[2] + i[3])
+            + sumaOdwrotnosciSkalarnie(zr, zi, j, doo, xr, xi);
+    }
+#endif
+
+    struct JadraAbertha {
+        void (*horner)(const double*, const double*, size_t, PunktyHornera, size_t, size_t);
+        complex<double> (*sumaOdwrotnosci)(const double*, const double*, size_t, size_t, double, double);
+    };
+
+    inline JadraAbertha wybierzJadraAbertha() {
+#ifdef WIELOMIAN_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return { hornerZespolonyAVX2, sumaOdwrotnosciAVX2 };
+#endif
+        return { hornerZespolonySkalarnie, sumaOdwrotnosciSkalarnie };
+    }
+
+    /**
+     * Przybliżenia początkowe na okręgach z wielokąta Newtona (górna otoczka wypukła punktów (i, log|a_i|)):
+     * odcinek od k do l daje l - k punktów na okręgu o promieniu (|a_k| / |a_l|)^(1 / (l - k)).
+     */
+    inline void przyblizeniaPoczatkowe(const vector<double>& a, double* zr, double* zi) {
+        size_t n = a.size() - 1;
+        vector<size_t> otoczka;
+        for (size_t i = 0; i <= n; ++i) {
+            if (a[i] == 0) continue;
+            auto y = [&](size_t k) { return log(abs(a[k])); };
+            while (otoczka.size() >= 2) {
+                size_t k = otoczka[otoczka.size() - 2], l = otoczka.back();
+                if ((y(l) - y(k)) * double(i - k) > (y(i) - y(k)) * double(l - k)) break;
+                otoczka.pop_back();
+            }
+            otoczka.push_back(i);
+        }
+
+        const double pi2 = 2 * acos(-1.0), przesuniecie = 0.7;
+        size_t p = 0;
+        for (size_t s = 0; s + 1 < otoczka.size(); ++s) {
+            size_t k = otoczka[s], l = otoczka[s + 1], ile = l - k;
+            double promien = pow(abs(a[k]) / abs(a[l]), 1.0 / double(ile));
+            for (size_t j = 0; j < ile; ++j, ++p) {
+                double kat = pi2 * double(j) / double(ile) + pi2 * double(s) / double(n) + przesuniecie;
+                zr[p] = promien * cos(kat);
+                zi[p] = promien * sin(kat);
+            }
+        }
+    }
+
+    /**
+     * Metoda Abertha–Ehrlicha: wszystkie pierwiastki naraz, z_k -= N_k / (1 - N_k * sum_{j != k} 1 / (z_k - z_j)),
+     * gdzie N_k = p(z_k) / p'(z_k). Wymaga a[0] != 0 i a[n] != 0, n >= 1.
+     * Dla |z| > 1 wielomian liczony jest jako z^n r(1/z) (r - współczynniki odwrócone), co nie przepełnia się przy dużych n.
+     * Pierwiastek, dla którego |p(z)| spadło do poziomu błędów zaokrągleń (eps * suma |a_i||z|^i, albo 4n razy tyle
+     * przez kilka kolejnych kroków — źle uwarunkowane pierwiastki zyskują jeszcze na paru krokach), zostaje zamrożony (deflacja niejawna):
+     * nie jest już poprawiany ani liczony, ale dalej odpycha pozostałe przez sumę Abertha.
+     * Jedna iteracja (metoda Jacobiego) dzieli aktywne pierwiastki na bloki rozdzielane w puli wątków.
+     */
+    inline vector<Pierwiastek> aberth(const vector<double>& a, size_t maksIteracji, PulaWatkow& pula) {
+        static const JadraAbertha jadra = wybierzJadraAbertha();
+        const size_t n = a.size() - 1, rozmiarBloku = 32, krokiWSzumie = 2;
+        const double eps = numeric_limits<double>::epsilon();
+
+        vector<double> odwrocone(a.rbegin(), a.rend()), abs1(n + 1), abs2(n + 1);
+        for (size_t i = 0; i <= n; ++i) {
+            abs1[i] = abs(a[i]);
+            abs2[i] = abs(odwrocone[i]);
+        }
+
+        vector<double> zr(n), zi(n), noweRe(n), noweIm(n), blad(n, numeric_limits<double>::infinity());
+        vector<char> zbiezny(n, 0);
+        vector<unsigned char> wSzumie(n, 0);
+        przyblizeniaPoczatkowe(a, zr.data(), zi.data());
+
+        vector<size_t> aktywne(n);
+        for (size_t k = 0; k < n; ++k) aktywne[k] = k;
+
+        function<void(size_t)> blok = [&](size_t b) {
+            size_t poczatek = b * rozmiarBloku, ile = min(rozmiarBloku, aktywne.size() - poczatek);
+
+            // punkty z |z| <= 1 idą na początek bufora (u = z), pozostałe na koniec (u = 1/z)
+            thread_local vector<double> bufor;
+            bufor.resize(7 * rozmiarBloku);
+            double* kol[7];
+            for (int c = 0; c < 7; ++c) kol[c] = bufor.data() + c * rozmiarBloku;
+            PunktyHornera pt{ kol[0], kol[1], kol[2], kol[3], kol[4], kol[5], kol[6] };
+            size_t indeks[rozmiarBloku];
+            size_t lewo = 0, prawo = ile;
+            for (size_t t = 0; t < ile; ++t) {
+                size_t k = aktywne[poczatek + t];
+                complex<double> z(zr[k], zi[k]);
+                size_t miejsce = abs(z) <= 1 ? lewo++ : --prawo;
+                if (miejsce >= lewo) z = 1.0 / z;
+                kol[0][miejsce] = z.real();
+                kol[1][miejsce] = z.imag();
+                indeks[miejsce] = k;
+            }
+            jadra.horner(a.data(), abs1.data(), n + 1, pt, 0, lewo);
+            jadra.horner(odwrocone.data(), abs2.data(), n + 1, pt, lewo, ile);
+
+            for (size_t t = 0; t < ile; ++t) {
+                size_t k = indeks[t];
+                complex<double> z(zr[k], zi[k]), p(pt.pRe[t], pt.pIm[t]), d(pt.dRe[t], pt.dIm[t]);
+                complex<double> newton;
+                if (p == 0.0) newton = 0;
+                else if (t < lewo) newton = p / d;
+                else newton = z / (double(n) - complex<double>(pt.re[t], pt.im[t]) * d / p);
+
+                blad[k] = double(n) * abs(newton);
+                double szum = eps * pt.skala[t];
+                if (abs(p) <= 4 * double(n) * szum) ++wSzumie[k];
+                if (abs(p) <= szum || wSzumie[k] > krokiWSzumie) {
+                    zbiezny[k] = 1;
+                    noweRe[k] = zr[k];
+                    noweIm[k] = zi[k];
+                    continue;
+                }
+
+                complex<double> suma = jadra.sumaOdwrotnosci(zr.data(), zi.data(), 0, k, zr[k], zi[k])
+                    + jadra.sumaOdwrotnosci(zr.data(), zi.data(), k + 1, n, zr[k], zi[k]);
+                complex<double> poprawka = newton / (1.0 - newton * suma);
+                if (!isfinite(poprawka.real()) || !isfinite(poprawka.imag())) poprawka = z * complex<double>(1e-3, 1e-3);
+                noweRe[k] = zr[k] - poprawka.real();
+                noweIm[k] = zi[k] - poprawka.imag();
+            }
+        };
+
+        for (size_t iteracja = 0; iteracja < maksIteracji && !aktywne.empty(); ++iteracja) {
+            pula.rownolegle((aktywne.size() + rozmiarBloku - 1) / rozmiarBloku, blok);
+            size_t zostaje = 0;
+            for (size_t k : aktywne) {
+                zr[k] = noweRe[k];
+                zi[k] = noweIm[k];
+                if (!zbiezny[k]) aktywne[zostaje++] = k;
+            }
+            aktywne.resize(zostaje);
+        }
+
+        vector<Pierwiastek> wynik(n);
+        for (size_t k = 0; k < n; ++k) wynik[k] = { { zr[k], zi[k] }, blad[k], zbiezny[k] != 0 };
+        return wynik;
+    }
+}
+
+#ifndef WIELOMIAN_LOKALNE
+#define WIELOMIAN_LOKALNE 8     // ile współczynników Wielomian trzyma w sobie, zanim sięgnie po stertę
+#endif
+
+/**
+ * Wektor z buforem lokalnym na N elementów: dopóki rozmiar się w nim mieści, nie alokuje pamięci.
+ * Po przekroczeniu N przenosi się na stertę i dalej rośnie geometrycznie. Tylko dla typów trywialnie kopiowalnych.
+ */
+template <class T, size_t N>
+class MalyWektor {
+    static_assert(is_trivially_copyable_v<T>, "MalyWektor obsluguje tylko typy trywialnie kopiowalne.");
+
+private:
+    T lokalne[N];
+    T* dane = lokalne;
+    size_t rozmiar = 0;
+    size_t pojemnosc = N;
+
+    bool naStercie() const { return dane != lokalne; }
+
+    void zwolnij() {
+        if (naStercie()) delete[] dane;
+        dane = lokalne;
+        pojemnosc = N;
+    }
+
+    void przejmij(MalyWektor& o) {
+        if (o.naStercie()) {
+            dane = o.dane;
+            pojemnosc = o.pojemnosc;
+            o.dane = o.lokalne;
+            o.pojemnosc = N;
+        }
+        else {
+            copy(o.lokalne, o.lokalne + o.rozmiar, lokalne);
+        }
+        rozmiar = o.rozmiar;
+        o.rozmiar = 0;
+    }
+
+public:
+    MalyWektor() = default;
+
+    template <class It>
+    MalyWektor(It poczatek, It koniec) {
+        reserve(size_t(distance(poczatek, koniec)));
+        for (; poczatek != koniec; ++poczatek) dane[rozmiar++] = *poczatek;
+    }
+
+    MalyWektor(const MalyWektor& o) : MalyWektor(o.begin(), o.end()) {}
+    MalyWektor(MalyWektor&& o) noexcept { przejmij(o); }
+
+    MalyWektor& operator=(const MalyWektor& o) {
+        if (this != &o) {
+            rozmiar = 0;
+            reserve(o.rozmiar);
+            copy(o.begin(), o.end(), dane);
+            rozmiar = o.rozmiar;
+        }
+        return *this;
+    }
+
+    MalyWektor& operator=(MalyWektor&& o) noexcept {
+        if (this != &o) {
+            zwolnij();
+            przejmij(o);
+        }
+        return *this;
+    }
+
+    ~MalyWektor() { zwolnij(); }
+
+    size_t size() const { return rozmiar; }
+    size_t capacity() const { return pojemnosc; }
+    bool empty() const { return rozmiar == 0; }
+    T* data() { return dane; }
+    const T* data() const { return dane; }
+    T* begin() { return dane; }
+    T* end() { return dane + rozmiar; }
+    const T* begin() const { return dane; }
+    const T* end() const { return dane + rozmiar; }
+    T& operator[](size_t i) { return dane[i]; }
+    const T& operator[](size_t i) const { return dane[i]; }
+    T& back() { return dane[rozmiar - 1]; }
+    const T& back() const { return dane[rozmiar - 1]; }
+
+    void reserve(size_t n) {
+        if (n <= pojemnosc) return;
+        T* nowe = new T[n];
+        copy(dane, dane + rozmiar, nowe);
+        if (naStercie()) delete[] dane;
+        dane = nowe;
+        pojemnosc = n;
+    }
+
+    void resize(size_t n, const T& wartosc = T()) {
+        if (n > pojemnosc) reserve(max(n, 2 * pojemnosc));
+        if (n > rozmiar) fill(dane + rozmiar, dane + n, wartosc);
+        rozmiar = n;
+    }
+
+    void assign(size_t n, const T& wartosc) {
+        rozmiar = 0;
+        resize(n, wartosc);
+    }
+
+    void push_back(const T& x) {
+        if (rozmiar == pojemnosc) reserve(2 * pojemnosc);
+        dane[rozmiar++] = x;
+    }
+
+    void pop_back() { --rozmiar; }
+    void clear() { rozmiar = 0; }
+
+    /**
+     * Oddaje nadmiar pamięci; jeśli elementy mieszczą się w buforze lokalnym, wraca do niego.
+     */
+    void shrink_to_fit() {
+        if (!naStercie() || rozmiar == pojemnosc) return;
+        T* stare = dane;
+        if (rozmiar <= N) {
+            dane = lokalne;
+            pojemnosc = N;
+        }
+        else {
+            dane = new T[rozmiar];
+            pojemnosc = rozmiar;
+        }
+        copy(stare, stare + rozmiar, dane);
+        delete[] stare;
+    }
+};
+
+namespace detail {
+    /**
+     * Górne ograniczenie długości zapisu jednej liczby przez zapiszLiczbe (także zespolonej).
+     */
+    inline constexpr size_t maksDlugoscLiczby = 64;
+
+    /**
+     * Zapisuje x od p tak jak operator<< przy domyślnych ustawieniach strumienia (format ogólny, 6 cyfr znaczących,
+     * liczby zespolone jako "(re,im)", elementy GF(P) jako wartość z [0, P)), ale bez strumienia i bez alokacji.
+     * Zwraca koniec zapisu.
+     */
+    template <class T>
+    char* zapiszLiczbe(char* p, const T& x) {
+        if constexpr (jestZespolony<T>::value) {
+            *p++ = '(';
+            p = zapiszLiczbe(p, x.real());
+            *p++ = ',';
+            p = zapiszLiczbe(p, x.imag());
+            *p++ = ')';
+            return p;
+        }
+        else if constexpr (is_floating_point_v<T>) {
+            return to_chars(p, p + maksDlugoscLiczby, x, chars_format::general, 6).ptr;
+        }
+        else if constexpr (jestLiczbaModulo<T>::value) {
+            return to_chars(p, p + maksDlugoscLiczby, x.wartosc()).ptr;
+        }
+        else {
+            return to_chars(p, p + maksDlugoscLiczby, x).ptr;
+        }
+    }
+
+    /**
+     * Odczytuje liczbę zapisaną przez zapiszLiczbe (zespoloną jako "(re,im)", ze spacjami wokół części).
+     * Zwraca wskaźnik za liczbą albo nullptr, jeśli od p nie zaczyna się poprawna liczba.
+     */
+    template <class T>
+    const char* czytajLiczbe(const char* p, const char* koniec, T& x) {
+        if constexpr (jestZespolony<T>::value) {
+            auto spacje = [&] { while (p != koniec && *p == ' ') ++p; };
+            typename T::value_type re, im;
+            if (p == koniec || *p != '(') return nullptr;
+            ++p;
+            spacje();
+            if (!(p = czytajLiczbe(p, koniec, re))) return nullptr;
+            spacje();
+            if (p == koniec || *p != ',') return nullptr;
+            ++p;
+            spacje();
+            if (!(p = czytajLiczbe(p, koniec, im))) return nullptr;
+            spacje();
+            if (p == koniec || *p != ')') return nullptr;
+            x = T(re, im);
+            return p + 1;
+        }
+        else if constexpr (jestLiczbaModulo<T>::value) {
+            long long v;
+            auto [koniecLiczby, blad] = from_chars(p, koniec, v);
+            if (blad != errc()) return nullptr;
+            x = T(v);
+            return koniecLiczby;
+        }
+        else {
+            auto [koniecLiczby, blad] = from_chars(p, koniec, x);
+            return blad == errc() ? koniecLiczby : nullptr;
+        }
+    }
+}
+
+namespace detail {
+    /**
+     * Typy współczynników, które mają format binarny (stały rozmiar i układ bajtów niezależny od kompilatora).
+     */
+    template <class T>
+    concept WspolczynnikBinarny = is_same_v<T, float> || is_same_v<T, double> ||
+        (is_integral_v<T> && is_signed_v<T> && sizeof(T) == 8) || is_same_v<T, complex<float>> || is_same_v<T, complex<double>>;
+
+    /**
+     * Kod typu współczynników zapisywany w nagłówku pliku PolynomialStore.
+     */
+    template <WspolczynnikBinarny T>
+    constexpr uint32_t kodTypuBinarnego() {
+        if constexpr (is_same_v<T, float>) return 1;
+        else if constexpr (is_same_v<T, double>) return 2;
+        else if constexpr (is_integral_v<T>) return 3;
+        else if constexpr (is_same_v<T, complex<float>>) return 4;
+        else return 5;
+    }
+
+    /**
+     * Odwraca kolejność bajtów (w liczbie zespolonej — osobno w każdej części).
+     */
+    template <class T>
+    T zamienBajty(T x) {
+        if constexpr (jestZespolony<T>::value) {
+            return T(zamienBajty(x.real()), zamienBajty(x.imag()));
+        }
+        else {
+            array<unsigned char, sizeof(T)> b;
+            memcpy(b.data(), &x, sizeof(T));
+            reverse(b.begin(), b.end());
+            memcpy(&x, b.data(), sizeof(T));
+            return x;
+        }
+    }
+
+    /**
+     * Zamiana między kolejnością little-endian (formatu binarnego) a kolejnością procesora; działa w obie strony.
+     */
+    template <class T>
+    T littleEndian(T x) {
+        if constexpr (endian::native == endian::little) return x;
+        else return zamienBajty(x);
+    }
+
+    /**
+     * Rekord formatu binarnego: liczba współczynników (uint64) i współczynniki od wyrazu wolnego, wszystko little-endian,
+     * dopełnione zerami do wielokrotności 8 bajtów, więc w pliku złożonym z rekordów każdy współczynnik jest wyrównany.
+     * Zwraca liczbę zapisanych bajtów.
+     */
+    template <WspolczynnikBinarny T>
+    size_t zapiszRekord(ostream& out, span<const T> w) {
+        uint64_t n = littleEndian(uint64_t(w.size()));
+        out.write(reinterpret_cast<const char*>(&n), sizeof n);
+        if constexpr (endian::native == endian::little) {
+            out.write(reinterpret_cast<const char*>(w.data()), streamsize(w.size() * sizeof(T)));
+        }
+        else {
+            for (const T& c : w) {
+                T z = zamienBajty(c);
+                out.write(reinterpret_cast<const char*>(&z), sizeof z);
+            }
+        }
+        size_t dane = sizeof n + w.size() * sizeof(T), dopelnienie = (8 - dane % 8) % 8;
+        static const char zera[8] = {};
+        out.write(zera, streamsize(dopelnienie));
+        if (!out) throw runtime_error("Blad zapisu wielomianu.");
+        return dane + dopelnienie;
+    }
+
+    /**
+     * Czyta rekord zapisany przez zapiszRekord. Współczynniki wczytywane są porcjami, więc uszkodzona długość
+     * kończy się wyjątkiem na końcu strumienia, a nie próbą alokacji ogromnego bufora.
+     */
+    template <WspolczynnikBinarny T>
+    vector<T> czytajRekord(istream& in) {
+        uint64_t n;
+        if (!in.read(reinterpret_cast<char*>(&n), sizeof n)) throw runtime_error("Brak rekordu wielomianu.");
+        n = littleEndian(n);
+        if (n == 0) throw runtime_error("Uszkodzony rekord wielomianu.");
+
+        vector<T> w;
+        for (uint64_t wczytane = 0; wczytane < n;) {
+            size_t porcja = size_t(min<uint64_t>(n - wczytane, 1 << 16));
+            w.resize(size_t(wczytane) + porcja);
+            if (!in.read(reinterpret_cast<char*>(w.data() + wczytane), streamsize(porcja * sizeof(T))))
+                throw runtime_error("Uszkodzony rekord wielomianu.");
+            wczytane += porcja;
+        }
+        for (T& c : w) c = littleEndian(c);
+
+        char dopelnienie[8];
+        in.read(dopelnienie, streamsize((8 - (sizeof n + n * sizeof(T)) % 8) % 8));
+        return w;
+    }
+}
+
+/**
+ * Wynik Wielomian::parsuj: opis == nullptr oznacza sukces, w przeciwnym razie pozycja wskazuje znak
+ * (licząc od początku tekstu), na którym parsowanie się zatrzymało.
+ */
+struct BladParsowania {
+    size_t pozycja = 0;
+    const char* opis = nullptr;
+
+    explicit operator bool() const { return opis != nullptr; }
+};
+
+namespace wielomiany {
+
+/**
+ * Znacznik węzłów leniwych wyrażeń (sum i różnic wielomianów), patrz SumaWyrazen.
+ */
+struct ZnacznikWyrazenia {};
+
+template <class T>
+concept WezelWyrazenia = is_base_of_v<ZnacznikWyrazenia, remove_cvref_t<T>>;
+
+/**
+ * Klasa reprezentująca wielomian o współczynnikach typu T (float, double, long double, complex, typy całkowite, LiczbaModulo).
+ * Przechowuje współczynniki i udostępnia operacje takie jak dodawanie, odejmowanie, mnożenie, ewaluacja i reprezentacja tekstowa.
+ * Algorytm mnożenia zależy od typu (patrz detail::mnoz); dzielenie wymaga ciała, a pierwiastki — liczb rzeczywistych.
+ */
+template <class T>
+class Wielomian {
+public:
+    using Wspolczynnik = T;
+    using Wyraz = pair<size_t, T>;     // (wykładnik, współczynnik) w postaci rzadkiej
+
+private:
+    MalyWektor<T, WIELOMIAN_LOKALNE> wsp;  // Współczynniki wielomianu, od wyrazu wolnego do najwyższego stopnia (postać gęsta)
+    vector<Wyraz> wyrazy;       // Niezerowe wyrazy rosnąco po wykładniku (postać rzadka)
+    size_t dlugoscRzadka = 0;   // W postaci rzadkiej: liczba współczynników, którą miałaby postać gęsta
+    bool rzadki = false;
+    SchematEwaluacji schemat = SchematEwaluacji::Auto;   // Sposób liczenia wartości w operator()
+    PolitykaNormalizacji normalizacja;                  // Usuwanie zer z końca; Domyslna — domyslnaNormalizacja
+
+    template <class P> friend struct LiscWyrazenia;
+
+    /**
+     * Tworzy wielomian w postaci rzadkiej z posortowanych, niezerowych wyrazów.
+     */
+    static Wielomian zRzadkich(vector<Wyraz> w, size_t dlugosc) {
+        Wielomian wynik{ T(0) };
+        wynik.wsp.clear();
+        wynik.wyrazy = move(w);
+        wynik.dlugoscRzadka = dlugosc;
+        wynik.rzadki = true;
+        wynik.poZmianie();
+        return wynik;
+    }
+
+    /**
+     * Zwraca współczynniki w postaci gęstej: bezpośrednio wsp albo rozwinięte do bufora.
+     */
+    span<const T> gesteWsp(vector<T>& bufor) const {
+        if (!rzadki) return wsp;
+        bufor.assign(dlugoscRzadka, T(0));
+        for (const Wyraz& w : wyrazy) bufor[w.first] = w.second;
+        return bufor;
+    }
+
+    /**
+     * Liczba współczynników (stopień + 1) niezależnie od postaci.
+     */
+    size_t dlugosc() const { return rzadki ? dlugoscRzadka : wsp.size(); }
+
+    /**
+     * Heurystyka gęstości: po każdej operacji wybiera postać według odsetka niezerowych współczynników.
+     * Próg powrotu do postaci gęstej jest dwa razy wyższy, żeby wielomian nie przełączał się w kółko.
+     */
+    void dobierzReprezentacje() {
+        size_t n = dlugosc();
+        if (n < minimalnaDlugoscRzadka) {
+            if (rzadki) naGesta();
+            return;
+        }
+        if (!rzadki) {
+            size_t niezerowe = count_if(wsp.begin(), wsp.end(), [](const T& c) { return c != T(0); });
+            if (niezerowe < n * progGestosci) naRzadka();
+        }
+        else if (wyrazy.size() > 2 * n * progGestosci) {
+            naGesta();
+        }
+    }
+
+public:
+    /**
+     * Stopień, od którego schemat Auto przestaje używać Hornera (patrz benchmarkEwaluacji); osobny dla każdego typu T.
+     */
+    static inline int progEstrina = 16;
+
+    /**
+     * Odsetek niezerowych współczynników, poniżej którego wielomian przechodzi do postaci rzadkiej.
+     */
+    static inline double progGestosci = 0.125;
+
+    /**
+     * Wielomiany krótsze niż tyle współczynników zawsze są gęste.
+     */
+    static inline size_t minimalnaDlugoscRzadka = 64;
+
+    /**
+     * Największy wykładnik akceptowany przez parsuj; stopien() zwraca int, więc wyższych nie da się przedstawić.
+     */
+    static constexpr size_t maksymalnyWykladnik = size_t(numeric_limits<int>::max());
+
+    /**
+     * Normalizacja wielomianów, które nie mają własnej (ustawNormalizacje); osobna dla każdego typu T.
+     */
+    static inline PolitykaNormalizacji domyslnaNormalizacja{ Normalizacja::DokladneZero, 0 };
+
+    /**
+     * Konstruktor tworzący wielomian na podstawie wektora współczynników.
+     * Usuwa zbędne zera z końca (według domyslnaNormalizacja) i sprawdza, czy wielomian nie jest pusty.
+     */
+    Wielomian(const vector<T>& wspolczynniki) : Wielomian(span<const T>(wspolczynniki)) {}
+
+    /**
+     * Konstruktor z listy współczynników, np. Wielomian({ 1, 2, 3 }); mały wielomian nie alokuje pamięci.
+     */
+    Wielomian(initializer_list<T> wspolczynniki) : Wielomian(span<const T>(wspolczynniki.begin(), wspolczynniki.size())) {}
+
+    /**
+     * Konstruktor z dowolnego ciągłego zakresu współczynników (od wyrazu wolnego).
+     */
+    explicit Wielomian(span<const T> wspolczynniki) : wsp(wspolczynniki.begin(), wspolczynniki.end()) {
+        if (wsp.empty())
+            throw invalid_argument("Wielomian nie moze byc pusty.");
+        poZmianie();
+    }
+
+    /**
+     * Materializuje leniwe wyrażenie (np. w1 + w2 - w3) w jednym przebiegu do jednego bufora.
+     * Gdy wszystkie liście są gęste, każdy współczynnik wyniku liczony jest od razu jako suma po liściach;
+     * gdy wszystkie są rzadkie, listy wyrazów są scalane; w przypadku mieszanym liście dopisują się do wspólnego bufora.
+     */
+    template <WezelWyrazenia E>
+        requires is_same_v<typename E::Wspolczynnik, T>
+    Wielomian(const E& e) {
+        size_t n = e.dlugosc();
+        if (e.wszystkieRzadkie()) {
+            *this = zRzadkich(e.rzadkie(T(1)), n);
+            return;
+        }
+
+        if (e.wszystkieGeste()) {
+            wsp.resize(n);
+            for (size_t i = 0; i < n; ++i) wsp[i] = e[i];
+        }
+        else {
+            wsp.assign(n, T(0));
+            e.dodajDo(wsp.data(), T(1));
+        }
+        poZmianie();
+    }
+
+    /**
+     * Przypisanie leniwego wyrażenia; wyrażenie może odwoływać się do *this.
+     */
+    template <WezelWyrazenia E>
+        requires is_same_v<typename E::Wspolczynnik, T>
+    Wielomian& operator=(const E& e) { return *this = Wielomian(e); }
+
+    /**
+     * Tworzy wielomian z listy wyrazów (wykładnik, współczynnik) w dowolnej kolejności.
+     * Wyrazy o tym samym wykładniku są sumowane. Postać (gęsta/rzadka) dobiera heurystyka gęstości.
+     */
+    static Wielomian zWyrazow(vector<Wyraz> w) {
+        sort(w.begin(), w.end(), [](const Wyraz& a, const Wyraz& b) { return a.first < b.first; });
+        vector<Wyraz> scalone;
+        for (const Wyraz& t : w) {
+            if (!scalone.empty() && scalone.back().first == t.first) scalone.back().second += t.second;
+            else scalone.push_back(t);
+        }
+        size_t dlugosc = scalone.empty() ? 1 : scalone.back().first + 1;
+        erase_if(scalone, [](const Wyraz& t) { return t.second == T(0); });
+        return zRzadkich(move(scalone), dlugosc);
+    }
+
+    /**
+     * Parsuje wielomian w formacie toString, np. "W(x) = 3x^2 + 2x + 1" albo "-x^3 + 0.5 - 2*x". Przedrostek "W(x) =" jest
+     * opcjonalny, wyrazy mogą stać w dowolnej kolejności, a powtórzone wykładniki są sumowane.
+     * Nie rzuca wyjątków: przy błędzie zwraca jego pozycję i opis, a wynik pozostaje bez zmian. Wykładniki powyżej
+     * maksymalnyWykladnik są odrzucane, zanim posłużą do wyznaczenia długości wyniku.
+     * Jedno przejście po tekście bez kopiowania go; wyrazy trafiają do bufora wątku, a gęsty wynik do bufora wynik,
+     * więc parsowanie w pętli do tego samego obiektu nie alokuje.
+     */
+    static BladParsowania parsuj(string_view tekst, Wielomian& wynik) {
+        const char* const poczatek = tekst.data();
+        const char* p = poczatek;
+        const char* const koniec = p + tekst.size();
+        auto spacje = [&] { while (p != koniec && (*p == ' ' || *p == '\t')) ++p; };
+        auto blad = [&](const char* opis) { return BladParsowania{ size_t(p - poczatek), opis }; };
+
+        spacje();
+        if (tekst.substr(size_t(p - poczatek)).starts_with("W(x)")) {
+            p += 4;
+            spacje();
+            if (p == koniec || *p != '=') return blad("Oczekiwano znaku = po W(x).");
+            ++p;
+            spacje();
+        }
+        if (p == koniec) return blad("Brak wyrazow wielomianu.");
+
+        static thread_local vector<Wyraz> wyrazy;
+        wyrazy.clear();
+        size_t najwyzszy = 0;
+        while (p != koniec) {
+            bool ujemny = false;
+            if (*p == '+' || *p == '-') {
+                ujemny = *p == '-';
+                ++p;
+                spacje();
+            }
+            else if (!wyrazy.empty()) {
+                return blad("Oczekiwano + lub - miedzy wyrazami.");
+            }
+
+            T c = T(1);
+            if (p == koniec || *p != 'x') {
+                const char* za = p != koniec && *p != '+' && *p != '-' ? detail::czytajLiczbe(p, koniec, c) : nullptr;
+                if (!za) return blad("Oczekiwano wspolczynnika.");
+                p = za;
+                spacje();
+                if (p != koniec && *p == '*') {
+                    ++p;
+                    spacje();
+                    if (p == koniec || *p != 'x') return blad("Oczekiwano x po *.");
+                }
+            }
+
+            size_t wykladnik = 0;
+            if (p != koniec && *p == 'x') {
+                ++p;
+                spacje();
+                wykladnik = 1;
+                if (p != koniec && *p == '^') {
+                    ++p;
+                    spacje();
+                    auto [za, bladLiczby] = from_chars(p, koniec, wykladnik);
+                    if (bladLiczby == errc::result_out_of_range || (bladLiczby == errc() && wykladnik > maksymalnyWykladnik))
+                        return blad("Wykladnik poza zakresem.");
+                    if (bladLiczby != errc()) return blad("Oczekiwano wykladnika.");
+                    p = za;
+                }
+            }
+
+            wyrazy.emplace_back(wykladnik, ujemny ? -c : c);
+            najwyzszy = max(najwyzszy, wykladnik);
+            spacje();
+        }
+
+        // Gęsto sumujemy w miejscu; rzadko (wysoki wykładnik, mało wyrazów) sortujemy i scalamy przez zWyrazow.
+        // Postać gęsta ma co najwyżej 1 / progGestosci razy więcej współczynników niż wyrazów w tekście.
+        size_t dlugosc = najwyzszy + 1;
+        if (dlugosc < minimalnaDlugoscRzadka || double(wyrazy.size()) >= dlugosc * progGestosci) {
+            wynik.wyrazy.clear();
+            wynik.rzadki = false;
+            wynik.wsp.assign(dlugosc, T(0));
+            for (const Wyraz& t : wyrazy) wynik.wsp[t.first] += t.second;
+            wynik.poZmianie();
+        }
+        else {
+            wynik = zWyrazow(wyrazy);
+        }
+        return {};
+    }
+
+    /**
+     * Zapisuje wielomian jako rekord formatu binarnego (patrz detail::zapiszRekord), zawsze w postaci gęstej.
+     * Zwraca liczbę zapisanych bajtów.
+     */
+    size_t zapiszBinarnie(ostream& out) const
+        requires detail::WspolczynnikBinarny<T>
+    {
+        vector<T> bufor;
+        return detail::zapiszRekord(out, gesteWsp(bufor));
+    }
+
+    /**
+     * Czyta wielomian zapisany przez zapiszBinarnie; rzuca runtime_error przy uszkodzonym lub uciętym rekordzie.
+     */
+    static Wielomian czytajBinarnie(istream& in)
+        requires detail::WspolczynnikBinarny<T>
+    {
+        return Wielomian(detail::czytajRekord<T>(in));
+    }
+
+    /**
+     * Czy wielomian jest przechowywany w postaci rzadkiej.
+     */
+    bool czyRzadki() const { return rzadki; }
+
+    /**
+     * Przechodzi do postaci gęstej (wektor wszystkich współczynników).
+     */
+    void naGesta() {
+        if (!rzadki) return;
+        vector<T> bufor;
+        gesteWsp(bufor);
+        wsp = MalyWektor<T, WIELOMIAN_LOKALNE>(bufor.begin(), bufor.end());
+        wyrazy.clear();
+        wyrazy.shrink_to_fit();
+        rzadki = false;
+    }
+
+    /**
+     * Przechodzi do postaci rzadkiej (tylko niezerowe wyrazy).
+     */
+    void naRzadka() {
+        if (rzadki) return;
+        wyrazy.clear();
+        for (size_t i = 0; i < wsp.size(); ++i)
+            if (wsp[i] != T(0)) wyrazy.emplace_back(i, wsp[i]);
+        dlugoscRzadka = wsp.size();
+        wsp.clear();
+        wsp.shrink_to_fit();
+        rzadki = true;
+    }
+
+    /**
+     * Zwraca niezerowe wyrazy (wykładnik, współczynnik) rosnąco po wykładniku, niezależnie od postaci.
+     */
+    vector<Wyraz> wyrazyNiezerowe() const {
+        if (rzadki) return wyrazy;
+        vector<Wyraz> wynik;
+        for (size_t i = 0; i < wsp.size(); ++i)
+            if (wsp[i] != T(0)) wynik.emplace_back(i, wsp[i]);
+        return wynik;
+    }
+
+    /**
+     * Zwraca współczynnik przy x^i (0 powyżej stopnia).
+     */
+    T wspolczynnik(size_t i) const {
+        if (!rzadki) return i < wsp.size() ? wsp[i] : T(0);
+        auto it = lower_bound(wyrazy.begin(), wyrazy.end(), i, [](const Wyraz& t, size_t k) { return t.first < k; });
+        return it != wyrazy.end() && it->first == i ? it->second : T(0);
+    }
+
+    /**
+     * Zwraca stopień wielomianu.
+     */
+    int stopien() const {
+        return dlugosc() - 1;
+    }
+
+    /**
+     * Zwraca tekstową reprezentację wielomianu w formie np. "W(x) = 3x^2 + 2x + 1".
+     * W postaci rzadkiej pomijane są zerowe wyrazy; współczynniki zespolone wypisywane są w nawiasach, np. (1,2)x.
+     * Liczby formatowane są tak jak przez operator<< (patrz formatTo).
+     */
+    string toString() const {
+        string wynik;
+        appendTo(wynik);
+        return wynik;
+    }
+
+    /**
+     * Zapisuje toString() do iteratora wyjściowego i zwraca iterator za ostatnim znakiem.
+     * Każdy wyraz formatowany jest przez to_chars do bufora na stosie (dla char* — od razu w miejscu docelowym),
+     * więc nie powstają żadne tymczasowe napisy ani strumienie.
+     */
+    template <class OutputIt>
+    OutputIt formatTo(OutputIt out) const {
+        constexpr string_view naglowek = "W(x) = ";
+        out = copy(naglowek.begin(), naglowek.end(), out);
+        bool pierwszy = true;
+        char bufor[maksDlugoscWyrazu];
+        dlaWyrazowMalejaco([&](const T& c, size_t i) {
+            if constexpr (is_same_v<OutputIt, char*>) out = zapiszWyraz(out, c, i, pierwszy);
+            else out = copy(bufor, zapiszWyraz(bufor, c, i, pierwszy), out);
+            pierwszy = false;
+        });
+        if (pierwszy) *out++ = '0';
+        return out;
+    }
+
+    /**
+     * Dopisuje toString() na koniec s; napis powiększany jest raz, dokładnie o dlugoscTekstu() znaków.
+     */
+    void appendTo(string& s) const {
+        size_t poczatek = s.size();
+        s.resize(poczatek + dlugoscTekstu());
+        formatTo(s.data() + poczatek);
+    }
+
+    /**
+     * Dokładna długość toString(), bez budowania napisu.
+     */
+    size_t dlugoscTekstu() const {
+        size_t dlugosc = string_view("W(x) = ").size();
+        bool pierwszy = true;
+        char bufor[maksDlugoscWyrazu];
+        dlaWyrazowMalejaco([&](const T& c, size_t i) {
+            dlugosc += size_t(zapiszWyraz(bufor, c, i, pierwszy) - bufor);
+            pierwszy = false;
+        });
+        return pierwszy ? dlugosc + 1 : dlugosc;
+    }
+
+    /**
+     * Ustawia schemat obliczania wartości dla tego wielomianu.
+     */
+    void ustawSchemat(SchematEwaluacji s) { schemat = s; }
+
+    /**
+     * Zwraca schemat, którego faktycznie używa operator() (Auto rozstrzygnięte według stopnia).
+     */
+    SchematEwaluacji wybranySchemat() const {
+        if (schemat != SchematEwaluacji::Auto) return schemat;
+        return stopien() < progEstrina ? SchematEwaluacji::Horner : SchematEwaluacji::Hybryda;
+    }
+
+    /**
+     * Ustawia normalizację dla tego wielomianu i od razu ją stosuje. Obowiązuje w operacjach w miejscu (+=, -=, *=);
+     * wyniki operacji tworzących nowy wielomian używają domyslnaNormalizacja.
+     */
+    void ustawNormalizacje(PolitykaNormalizacji p) {
+        normalizacja = p;
+        poZmianie();
+    }
+
+    /**
+     * Zwraca normalizację, której faktycznie używa ten wielomian (Domyslna rozstrzygnięta).
+     */
+    PolitykaNormalizacji wybranaNormalizacja() const {
+        return normalizacja.rodzaj == Normalizacja::Domyslna ? domyslnaNormalizacja : normalizacja;
+    }
+
+    /**
+     * Zwraca wartość wielomianu dla danego x.
+     */
+    T operator()(T x) const {
+        if (rzadki) return detail::wartoscRzadka(wyrazy, x);
+        return detail::wartosc(wsp.data(), wsp.size(), x, wybranySchemat());
+    }
+
+    /**
+     * Oblicza wartości wielomianu w wielu punktach naraz: out[i] = W(xs[i]).
+     * Horner liczony jest na kilku przeplatanych łańcuchach, dla double i float wektorowo (AVX-512, AVX2 albo skalarnie, wybór w czasie działania).
+     * Warianty wektorowe używają FMA, więc wynik może różnić się od operator() na ostatnim bicie.
+     */
+    void evaluate(span<const T> xs, span<T> out) const {
+        if (xs.size() != out.size())
+            throw invalid_argument("Liczba punktow i wynikow musi byc rowna.");
+        if (rzadki) {
+            for (size_t i = 0; i < xs.size(); ++i) out[i] = detail::wartoscRzadka(wyrazy, xs[i]);
+            return;
+        }
+        detail::hornerWielu(wsp.data(), wsp.size(), xs.data(), out.data(), xs.size());
+    }
+
+    /**
+     * Wartość i pochodne w jednym przejściu po współczynnikach: out[j] = W^(j)(x) dla j = 0..k (out.size() == k + 1).
+     * Pochodne nie są budowane jako osobne wielomiany; w postaci rzadkiej każdy wyraz c x^e wnosi
+     * c e (e-1) ... (e-j+1) x^(e-j) do kolejnych pochodnych.
+     */
+    void evalWithDerivatives(T x, span<T> out) const {
+        if (out.empty())
+            throw invalid_argument("Liczba pochodnych musi byc nieujemna.");
+        size_t k = out.size() - 1;
+        if (!rzadki) {
+            detail::hornerPochodneSkalarnie(wsp.data(), wsp.size(), k, &x, out.data(), 1);
+            return;
+        }
+        fill(out.begin(), out.end(), T(0));
+        for (const Wyraz& w : wyrazy) {
+            size_t e = w.first, ile = min(k, e);
+            T czynnik = w.second;
+            for (size_t j = 0; j < ile; ++j) czynnik *= T(e - j);
+            T potega = detail::potega(x, e - ile);
+            for (size_t j = ile + 1; j-- > 0;) {
+                out[j] += czynnik * potega;
+                if (j > 0) {
+                    czynnik /= T(e - j + 1);
+                    potega *= x;
+                }
+            }
+        }
+    }
+
+    /**
+     * Wersja zwracająca wektor [W(x), W'(x), ..., W^(k)(x)].
+     */
+    vector<T> evalWithDerivatives(T x, size_t k) const {
+        vector<T> wynik(k + 1);
+        evalWithDerivatives(x, span<T>(wynik));
+        return wynik;
+    }
+
+    /**
+     * Wartości i k pochodnych w wielu punktach: out[i * (k + 1) + j] = W^(j)(xs[i]).
+     * Postać gęsta double liczona jest wektorowo (AVX2 + FMA, cztery punkty naraz, wybór w czasie działania).
+     */
+    void evalWithDerivatives(span<const T> xs, size_t k, span<T> out) const {
+        if (out.size() != xs.size() * (k + 1))
+            throw invalid_argument("Bufor wynikow musi miec rozmiar liczba punktow * (k + 1).");
+        if (rzadki) {
+            for (size_t i = 0; i < xs.size(); ++i) evalWithDerivatives(xs[i], out.subspan(i * (k + 1), k + 1));
+            return;
+        }
+        detail::hornerPochodnychWielu(wsp.data(), wsp.size(), k, xs.data(), out.data(), xs.size());
+    }
+
+    /**
+     * Oblicza wartości wielomianu w n punktach w czasie O(n log^2 n) drzewem iloczynów częściowych:
+     * W jest redukowany modulo iloczyny (x - x_i) coraz mniejszych grup punktów, a małe grupy liczone są Hornerem.
+     * W arytmetyce double iloczyny (x - x_i) mają współczynniki rosnące wykładniczo z liczbą punktów, więc dla węzłów
+     * rozłożonych na dużym przedziale (np. węzły Czebyszewa na [-1, 1]) wynik traci dokładność już od kilkudziesięciu
+     * punktów — wtedy należy użyć evaluate. Punkty skupione blisko zera nie sprawiają kłopotu. Tylko dla double.
+     */
+    void ewaluujWielopunktowo(span<const double> xs, span<double> out) const
+        requires is_same_v<T, double>
+    {
+        if (xs.size() != out.size())
+            throw invalid_argument("Liczba punktow i wynikow musi byc rowna.");
+        if (xs.size() <= 32) {
+            evaluate(xs, out);
+            return;
+        }
+
+        vector<double> bufor;
+        span<const double> w = gesteWsp(bufor);
+        detail::DrzewoIloczynow drzewo(xs);
+        const vector<double>& m = drzewo.korzen();
+        vector<double> r = detail::dziel(w.data(), w.size(), m.data(), m.size()).reszta;
+        drzewo.ewaluuj(r, drzewo.poziomy.size() - 1, 0, xs, out.data());
+    }
+
+    /**
+     * Tworzy wielomian stopnia co najwyżej n - 1 przechodzący przez punkty (xs[i], ys[i]).
+     * Interpolacja Lagrange'a na drzewie iloczynów częściowych: wagi y_i / M'(x_i) liczone wielopunktowo,
+     * potem łączone od liści do korzenia. Koszt O(n log^2 n); punkty muszą być parami różne.
+     * Uwarunkowanie jest takie jak przy ewaluujWielopunktowo (a baza potęgowa sama jest źle uwarunkowana dla wielu węzłów).
+     * Wagi M'(x_i) wyznaczone z M(x) w bazie potęgowej tracą dokładność już od kilkudziesięciu węzłów, więc
+     * do detail::progWagInterpolacji węzłów liczone są wprost jako iloczyny (x_i - x_j); powyżej — wielopunktowo,
+     * a waga zerowa lub nieskończona liczona jest wprost. Dla kilkudziesięciu równoodległych węzłów rzeczywistych
+     * sam wynik w bazie potęgowej przestaje być dokładny niezależnie od wag.
+     * Powtórzone węzły zgłaszane są jako invalid_argument, a iloraz y_i / M'(x_i) albo współczynnik
+     * wyniku poza zakresem double jako domain_error.
+     */
+    static Wielomian interpoluj(span<const double> xs, span<const double> ys)
+        requires is_same_v<T, double>
+    {
+        if (xs.empty() || xs.size() != ys.size())
+            throw invalid_argument("Interpolacja wymaga niepustej i rownej liczby wezlow i wartosci.");
+        vector<double> posortowane(xs.begin(), xs.end());
+        sort(posortowane.begin(), posortowane.end());
+        if (adjacent_find(posortowane.begin(), posortowane.end()) != posortowane.end())
+            throw invalid_argument("Wezly interpolacji musza byc parami rozne.");
+
+        detail::DrzewoIloczynow drzewo(xs);
+        vector<double> wagi(xs.size(), 0.0);
+        if (xs.size() > detail::progWagInterpolacji) {
+            const vector<double>& m = drzewo.korzen();
+            vector<double> pochodna(max<size_t>(m.size() - 1, 1), 0);
+            for (size_t i = 1; i < m.size(); ++i) pochodna[i - 1] = m[i] * i;
+            Wielomian(pochodna).ewaluujWielopunktowo(xs, wagi);
+        }
+        for (size_t i = 0; i < xs.size(); ++i) {
+            if (wagi[i] != 0 && isfinite(wagi[i])) {
+                wagi[i] = ys[i] / wagi[i];
+                continue;
+            }
+            // iloczyn (x_i - x_j) jako mantysa * 2^wykladnik, żeby nie zaniknął przy wielu bliskich węzłach
+            double mantysa = 1;
+            long long wykladnik = 0;
+            for (size_t j = 0; j < xs.size(); ++j) {
+                if (j == i) continue;
+                int e;
+                mantysa = frexp(mantysa * (xs[i] - xs[j]), &e);
+                wykladnik += e;
+            }
+            wagi[i] = ys[i] == 0 ? 0.0 : ldexp(ys[i] / mantysa, int(clamp<long long>(-wykladnik, -1 << 20, 1 << 20)));
+            if (!isfinite(wagi[i]))
+                throw domain_error("Interpolacja zle uwarunkowana: y_i / M'(x_i) nie miesci sie w zakresie double.");
+        }
+        vector<double> wynik = drzewo.kombinacja(wagi);
+        if (!all_of(wynik.begin(), wynik.end(), [](double c) { return isfinite(c); }))
+            throw domain_error("Interpolacja zle uwarunkowana: wspolczynniki nie mieszcza sie w zakresie double.");
+        return Wielomian(wynik);
+    }
+
+    /**
+     * Operator mnożenia dwóch wielomianów.
+     * Dla małych stopni mnoży szkolnie, w środkowym zakresie algorytmem Karatsuby,
+     * powyżej ProgiMnozenia::fft przez FFT (patrz detail::ograniczenieBleduFFT).
+     * Dwa wielomiany rzadkie mnożone są przez scalanie kopcem, a rzadki z gęstym przez sumę przesuniętych kopii,
+     * o ile to tańsze od mnożenia w postaci gęstej.
+     */
+    Wielomian operator*(const Wielomian& o) const {
+        size_t dl = dlugosc() + o.dlugosc() - 1;
+        if (rzadki && o.rzadki)
+            return zRzadkich(detail::mnozRzadkie(wyrazy, o.wyrazy), dl);
+
+        if (rzadki != o.rzadki) {
+            const Wielomian& r = rzadki ? *this : o;
+            const Wielomian& g = rzadki ? o : *this;
+            double kosztGesty = 4.0 * dl * log2(double(dl));
+            if (double(r.wyrazy.size()) * g.wsp.size() < kosztGesty) {
+                vector<T> wynik(dl, T(0));
+                for (const Wyraz& t : r.wyrazy)
+                    for (size_t j = 0; j < g.wsp.size(); ++j)
+                        wynik[t.first + j] += t.second * g.wsp[j];
+                return Wielomian(wynik);
+            }
+        }
+
+        vector<T> buforA, buforB;
+        span<const T> a = gesteWsp(buforA), b = o.gesteWsp(buforB);
+        return Wielomian(detail::mnoz(a.data(), a.size(), b.data(), b.size()));
+    }
+
+    /**
+     * Dzielenie z resztą: zwraca (iloraz, reszta), przy czym *this = iloraz * d + reszta i stopień reszty < stopnia d.
+     * Krótkie dzielniki dzielone są pisemnie, długie przez odwrotność szeregu liczoną iteracją Newtona,
+     * co kosztuje tyle co kilka mnożeń. Dzielenie przez wielomian zerowy rzuca domain_error.
+     * Niedostępne dla współczynników całkowitych, bo iloraz zwykle wychodzi poza liczby całkowite.
+     */
+    pair<Wielomian, Wielomian> divmod(const Wielomian& d) const
+        requires (!is_integral_v<T>)
+    {
+        vector<T> buforA, buforB;
+        span<const T> a = gesteWsp(buforA), b = d.gesteWsp(buforB);
+        detail::IlorazIReszta<T> wynik = detail::dziel(a.data(), a.size(), b.data(), b.size());
+        return { Wielomian(wynik.iloraz), Wielomian(wynik.reszta) };
+    }
+
+    /**
+     * Największy wspólny dzielnik (unormowany, o wiodącym współczynniku 1) liczony z rzędu numerycznego
+     * macierzy Sylvestera: tolerancja jest względna (wartości szczególne do normy wejść przeskalowanych do 1),
+     * więc działa bez strojenia także dla stopni rzędu setek. Koszt O((deg a + deg b)^3); gdy suma stopni
+     * przekracza detail::progNwdSylvestera, liczymy algorytmem Euklidesa, który w arytmetyce przybliżonej
+     * odnajduje wspólny czynnik tylko przy dobrze uwarunkowanych danych. NWD dwóch wielomianów zerowych to wielomian zerowy.
+     */
+    static Wielomian nwd(const Wielomian& a, const Wielomian& b, double tolerancja = 1e-9)
+        requires WspolczynnikPrzyblizony<T>
+    {
+        vector<T> buforA, buforB;
+        span<const T> wa = a.gesteWsp(buforA), wb = b.gesteWsp(buforB);
+        return Wielomian(detail::nwdSylvester(vector<T>(wa.begin(), wa.end()), vector<T>(wb.begin(), wb.end()), tolerancja));
+    }
+
+    /**
+     * Unormowany największy wspólny dzielnik nad GF(P), liczony dokładnie (pół-NWD dla dużych stopni, patrz detail::nwdDokladny).
+     * NWD dwóch wielomianów zerowych to wielomian zerowy.
+     */
+    static Wielomian nwd(const Wielomian& a, const Wielomian& b)
+        requires jestLiczbaModulo<T>::value
+    {
+        vector<T> buforA, buforB;
+        span<const T> wa = a.gesteWsp(buforA), wb = b.gesteWsp(buforB);
+        vector<T> g = detail::nwdDokladny(vector<T>(wa.begin(), wa.end()), vector<T>(wb.begin(), wb.end()));
+        if (g.empty()) g.push_back(T(0));
+        return Wielomian(g);
+    }
+
+    /**
+     * Wszystkie pierwiastki zespolone (z krotnościami) metodą Abertha–Ehrlicha, z oszacowaniem błędu każdego z nich.
+     * Iteracje rozkładane są na wspólną pulę wątków; pierwiastki zerowe (x^k | W) wyłączane są dokładnie.
+     * Dla współczynników rzeczywistych; iteracje liczone są w double.
+     */
+    vector<Pierwiastek> pierwiastki(size_t maksIteracji = 200) const
+        requires is_floating_point_v<T>
+    {
+        vector<T> bufor;
+        span<const T> w = gesteWsp(bufor);
+        size_t gora = w.size(), zera = 0;
+        while (gora > 0 && w[gora - 1] == 0) --gora;
+        if (gora == 0) throw domain_error("Wielomian zerowy ma nieskonczenie wiele pierwiastkow.");
+        while (w[zera] == 0) ++zera;
+
+        vector<Pierwiastek> wynik(zera, Pierwiastek{ 0.0, 0.0, true });
+        vector<double> a(w.begin() + zera, w.begin() + gora);
+        if (a.size() == 2) wynik.push_back({ -a[0] / a[1], 0.0, true });
+        else if (a.size() > 2) {
+            vector<Pierwiastek> reszta = detail::aberth(a, maksIteracji, detail::PulaWatkow::globalna());
+            wynik.insert(wynik.end(), reszta.begin(), reszta.end());
+        }
+        return wynik;
+    }
+
+    /**
+     * Przesunięcie Taylora: zwraca W(x + a). Krótkie wielomiany przesuwane są kwadratowo, długie dziel i zwyciężaj
+     * na potęgach (x + a)^h w czasie O(M(n) log n) (patrz detail::przesunTaylora). Nad GF(P), gdy stopień jest
+     * mniejszy od P, wystarcza jeden splot z silniami, O(M(n)) (patrz detail::przesunSplotem).
+     */
+    Wielomian shift(T a) const {
+        vector<T> bufor;
+        span<const T> w = gesteWsp(bufor);
+        if constexpr (jestLiczbaModulo<T>::value) {
+            if (w.size() > detail::progPrzesuniecia && w.size() <= T::modul)
+                return Wielomian(detail::przesunSplotem(vector<T>(w.begin(), w.end()), a));
+        }
+        return Wielomian(detail::przesunTaylora(w.data(), w.size(), a));
+    }
+
+    /**
+     * Złożenie: zwraca W(q(x)), dziel i zwyciężaj na potęgach q^(2^k) (patrz detail::zloz).
+     */
+    Wielomian compose(const Wielomian& q) const {
+        vector<T> buforW, buforQ;
+        span<const T> w = gesteWsp(buforW), wq = q.gesteWsp(buforQ);
+        return Wielomian(detail::zloz(w.data(), w.size(), vector<T>(wq.begin(), wq.end())));
+    }
+
+    /**
+     * Potęga W^e. Dla współczynników całkowitych i z GF(P) (gdy stopień wyniku jest mniejszy od P) podstawy o kilku
+     * wyrazach (po wyłączeniu x^s) liczone są rekurencją Millera w O(e * d * t) (patrz detail::oplacaSieMiller); pozostałe szybkim potęgowaniem na dwóch
+     * buforach (detail::potegaBinarna), a rzadkie — mnożeniem rzadkim, żeby nie rozwijać ich do postaci gęstej.
+     */
+    Wielomian pow(unsigned e) const {
+        if (rzadki) {
+            Wielomian wynik{ T(1) }, podstawa = *this;
+            for (; e; e >>= 1) {
+                if (e & 1) wynik = wynik * podstawa;
+                if (e > 1) podstawa = podstawa * podstawa;
+            }
+            return wynik;
+        }
+        if constexpr ((is_integral_v<T> && is_signed_v<T>) || jestLiczbaModulo<T>::value) {
+            size_t s = 0;
+            while (s + 1 < wsp.size() && wsp[s] == T(0)) ++s;
+            // nad GF(P) rekurencja dzieli przez numery współczynników, więc stopień wyniku musi być mniejszy od P
+            bool stopienPonizejP = true;
+            if constexpr (jestLiczbaModulo<T>::value) stopienPonizejP = uint64_t(wsp.size() - 1 - s) * e < T::modul;
+            if (stopienPonizejP && detail::oplacaSieMiller(wsp.data() + s, wsp.size() - s, e)) {
+                vector<T> q = detail::potegaMillera(wsp.data() + s, wsp.size() - s, e);
+                if (s > 0) q.insert(q.begin(), s * e, T(0));
+                return Wielomian(q);
+            }
+        }
+        return Wielomian(detail::potegaBinarna(wsp.data(), wsp.size(), e));
+    }
+
+    /**
+     * Operator dzielenia (iloraz z dzielenia z resztą).
+     */
+    Wielomian operator/(const Wielomian& d) const requires (!is_integral_v<T>) { return divmod(d).first; }
+
+    /**
+     * Operator reszty z dzielenia.
+     */
+    Wielomian operator%(const Wielomian& d) const requires (!is_integral_v<T>) { return divmod(d).second; }
+
+    /**
+     * Operator dzielenia i przypisania.
+     */
+    Wielomian& operator/=(const Wielomian& d) requires (!is_integral_v<T>) { return *this = *this / d; }
+
+    /**
+     * Operator reszty i przypisania.
+     */
+    Wielomian& operator%=(const Wielomian& d) requires (!is_integral_v<T>) { return *this = *this % d; }
+
+    /**
+     * Operator dodawania i przypisania.
+     * Działa w miejscu; bufor rośnie geometrycznie, więc sumowanie w pętli nie alokuje w stanie ustalonym.
+     */
+    Wielomian& operator+=(const Wielomian& o) { return dodajWMiejscu(o, T(1)); }
+
+    /**
+     * Operator odejmowania i przypisania.
+     */
+    Wielomian& operator-=(const Wielomian& o) { return dodajWMiejscu(o, T(-1)); }
+
+    /**
+     * Operator mnożenia i przypisania.
+     * Dla małych gęstych czynników liczy iloczyn szkolnie w miejscu (od najwyższego współczynnika w dół),
+     * większe przekazuje do operator*.
+     */
+    Wielomian& operator*=(const Wielomian& o) {
+        size_t n = dlugosc(), m = o.dlugosc();
+        if (&o == this || rzadki || o.rzadki || min(n, m) >= ProgiMnozenia::karatsuba)
+            return *this = *this * o;
+
+        zapewnijDlugosc(n + m - 1);
+        for (size_t i = n; i-- > 0;) {
+            T c = wsp[i];
+            wsp[i] = c * o.wsp[0];
+            for (size_t j = 1; j < m; ++j)
+                wsp[i + j] += c * o.wsp[j];
+        }
+        poZmianie();
+        return *this;
+    }
+
+    /**
+     * Mnożenie przez skalar w miejscu.
+     */
+    Wielomian& operator*=(T s) {
+        if (rzadki) {
+            for (Wyraz& t : wyrazy) t.second *= s;
+            erase_if(wyrazy, [](const Wyraz& t) { return t.second == T(0); });
+        }
+        else {
+            for (T& c : wsp) c *= s;
+        }
+        poZmianie();
+        return *this;
+    }
+
+    /**
+     * Dodawanie, odejmowanie i mnożenie z ginącym argumentem: wynik powstaje w jego buforze, bez alokacji
+     * (o ile bufor ma dość miejsca), więc acc = move(acc) + w w pętli działa jak acc += w.
+     */
+    friend Wielomian operator+(Wielomian&& a, const Wielomian& b) { a += b; return move(a); }
+    friend Wielomian operator+(const Wielomian& a, Wielomian&& b) { b += a; return move(b); }
+    friend Wielomian operator+(Wielomian&& a, Wielomian&& b) { a += b; return move(a); }
+
+    friend Wielomian operator-(Wielomian&& a, const Wielomian& b) { a -= b; return move(a); }
+    friend Wielomian operator-(Wielomian&& a, Wielomian&& b) { a -= b; return move(a); }
+    friend Wielomian operator-(const Wielomian& a, Wielomian&& b) {
+        if (&a == &b) return move(b *= T(0));
+        b *= T(-1);
+        b += a;
+        return move(b);
+    }
+
+    friend Wielomian operator*(Wielomian&& a, const Wielomian& b) { a *= b; return move(a); }
+    friend Wielomian operator*(const Wielomian& a, Wielomian&& b) { b *= a; return move(b); }
+    friend Wielomian operator*(Wielomian&& a, Wielomian&& b) { a *= b; return move(a); }
+
+    /**
+     * Równość współczynników; tylko dla współczynników liczonych dokładnie (całkowitych i z GF(P)).
+     */
+    friend bool operator==(const Wielomian& a, const Wielomian& b)
+        requires (!WspolczynnikPrzyblizony<T>)
+    {
+        vector<T> buforA, buforB;
+        return ranges::equal(a.gesteWsp(buforA), b.gesteWsp(buforB));
+    }
+
+private:
+    static constexpr size_t maksDlugoscWyrazu = detail::maksDlugoscLiczby + 32;   // " + ", liczba, "x^" i wykładnik
+
+    /**
+     * Wywołuje f(współczynnik, wykładnik) dla wyrazów od najwyższego wykładnika; w postaci rzadkiej tylko dla niezerowych.
+     */
+    template <class F>
+    void dlaWyrazowMalejaco(F&& f) const {
+        if (rzadki)
+            for (size_t k = wyrazy.size(); k-- > 0;) f(wyrazy[k].second, wyrazy[k].first);
+        else
+            for (size_t i = wsp.size(); i-- > 0;) f(wsp[i], i);
+    }
+
+    /**
+     * Zapisuje od p wyraz c x^i w formacie toString, poprzedzony znakiem " + " / " - ", jeśli nie jest pierwszy.
+     * Zajmuje co najwyżej maksDlugoscWyrazu znaków; zwraca koniec zapisu.
+     */
+    static char* zapiszWyraz(char* p, const T& c, size_t i, bool pierwszy) {
+        if constexpr (jestZespolony<T>::value || jestLiczbaModulo<T>::value) {
+            if (!pierwszy) p = copy_n(" + ", 3, p);
+            if (c != T(1) || i == 0) p = detail::zapiszLiczbe(p, c);
+        }
+        else {
+            if (!pierwszy) p = copy_n(c >= 0 ? " + " : " - ", 3, p);
+            else if (c < 0) *p++ = '-';
+            if (abs(c) != 1 || i == 0) p = detail::zapiszLiczbe(p, T(abs(c)));
+        }
+        if (i > 0) {
+            *p++ = 'x';
+            if (i > 1) {
+                *p++ = '^';
+                p = to_chars(p, p + 24, i).ptr;
+            }
+        }
+        return p;
+    }
+
+    /**
+     * Wydłuża gęsty bufor do n współczynników (dopisując zera), podwajając pojemność przy braku miejsca.
+     */
+    void zapewnijDlugosc(size_t n) {
+        if (n <= wsp.size()) return;
+        if (n > wsp.capacity()) wsp.reserve(max(n, 2 * wsp.capacity()));
+        wsp.resize(n, T(0));
+    }
+
+    /**
+     * Porządki po operacji: normalizacja i wybór postaci.
+     */
+    void poZmianie() {
+        normalizuj();
+        dobierzReprezentacje();
+    }
+
+    /**
+     * Usuwa znikające współczynniki przy najwyższych potęgach według wybranaNormalizacja. Skrócony bufor zachowuje
+     * pojemność, a kolejne operacje w miejscu rozszerzają go tylko do faktycznego stopnia, więc przy częstym
+     * znoszeniu się wyrazów długość nie narasta. W postaci rzadkiej długość jest ustawiana na najwyższy wykładnik + 1.
+     */
+    void normalizuj() {
+        PolitykaNormalizacji p = wybranaNormalizacja();
+        if (p.rodzaj == Normalizacja::Brak) return;
+
+        auto znika = [&] {
+            if constexpr (jestLiczbaModulo<T>::value) {
+                return [](const T& c) { return c == T(0); };   // GF(P) nie ma modułu: znikają tylko dokładne zera
+            }
+            else {
+                using Modul = conditional_t<is_integral_v<T>, double, decltype(abs(T{}))>;
+                Modul prog = 0;
+                if (p.rodzaj != Normalizacja::DokladneZero) {
+                    prog = Modul(p.epsilon);
+                    if (p.rodzaj == Normalizacja::EpsilonWzgledny) {
+                        Modul najwiekszy = 0;
+                        if (rzadki) for (const Wyraz& t : wyrazy) najwiekszy = max(najwiekszy, Modul(abs(t.second)));
+                        else for (const T& c : wsp) najwiekszy = max(najwiekszy, Modul(abs(c)));
+                        prog *= najwiekszy;
+                    }
+                }
+                return [prog](const T& c) { return c == T(0) || Modul(abs(c)) <= prog; };
+            }
+        }();
+
+        if (rzadki) {
+            while (!wyrazy.empty() && znika(wyrazy.back().second)) wyrazy.pop_back();
+            dlugoscRzadka = wyrazy.empty() ? 1 : wyrazy.back().first + 1;
+        }
+        else {
+            size_t n = wsp.size();
+            while (n > 1 && znika(wsp[n - 1])) --n;
+            wsp.resize(n);
+        }
+    }
+
+    /**
+     * *this += znak * o bez tworzenia nowego wielomianu.
+     */
+    Wielomian& dodajWMiejscu(const Wielomian& o, T znak) {
+        if (rzadki && o.rzadki) {
+            wyrazy = detail::dodajRzadkie(wyrazy, o.wyrazy, znak);
+            dlugoscRzadka = max(dlugoscRzadka, o.dlugoscRzadka);
+            poZmianie();
+            return *this;
+        }
+
+        naGesta();
+        zapewnijDlugosc(o.dlugosc());
+        if (o.rzadki)
+            for (const Wyraz& t : o.wyrazy) wsp[t.first] += znak * t.second;
+        else if (znak == T(1))
+            detail::dodajWektory(wsp.data(), o.wsp.data(), o.wsp.size());
+        else
+            for (size_t i = 0; i < o.wsp.size(); ++i) wsp[i] += znak * o.wsp[i];
+        poZmianie();
+        return *this;
+    }
+};
+
+/**
+ * Liść wyrażenia: wielomian trzymany przez referencję (lvalue) albo przez wartość (przeniesiony temporariusz),
+ * żeby wyrażenie nie odwoływało się do obiektu, który już nie istnieje.
+ */
+template <class P>
+struct LiscWyrazenia {
+    using Wspolczynnik = typename remove_cvref_t<P>::Wspolczynnik;
+    using Wyraz = typename remove_cvref_t<P>::Wyraz;
+
+    P w;
+
+    size_t dlugosc() const { return w.dlugosc(); }
+    bool wszystkieGeste() const { return !w.rzadki; }
+    bool wszystkieRzadkie() const { return w.rzadki; }
+    Wspolczynnik operator[](size_t i) const { return i < w.wsp.size() ? w.wsp[i] : Wspolczynnik(0); }
+    Wspolczynnik operator()(Wspolczynnik x) const { return w(x); }
+
+    void dodajDo(Wspolczynnik* out, Wspolczynnik znak) const {
+        if (w.rzadki)
+            for (const Wyraz& t : w.wyrazy) out[t.first] += znak * t.second;
+        else if (znak == Wspolczynnik(1))
+            detail::dodajWektory(out, w.wsp.data(), w.wsp.size());
+        else
+            for (size_t i = 0; i < w.wsp.size(); ++i) out[i] += znak * w.wsp[i];
+    }
+
+    vector<Wyraz> rzadkie(Wspolczynnik znak) const {
+        vector<Wyraz> wynik = w.wyrazy;
+        if (znak != Wspolczynnik(1))
+            for (Wyraz& t : wynik) t.second *= znak;
+        return wynik;
+    }
+};
+
+/**
+ * Wspólne metody węzłów wyrażeń; operacje wymagające całego wielomianu materializują wyrażenie.
+ */
+template <class D>
+struct WyrazenieWielomianowe : ZnacznikWyrazenia {
+    int stopien() const { return Wielomian<typename D::Wspolczynnik>(static_cast<const D&>(*this)).stopien(); }
+    string toString() const { return Wielomian<typename D::Wspolczynnik>(static_cast<const D&>(*this)).toString(); }
+};
+
+/**
+ * Leniwa suma (Znak = 1) albo różnica (Znak = -1) dwóch wyrażeń.
+ * Nic nie liczy do chwili zamiany na Wielomian; wartość w punkcie liczona jest bez materializacji.
+ * Iloczyny nie są leniwe: operator* zwraca gotowy Wielomian, który trafia do drzewa jako liść przez wartość,
+ * więc każdy iloczyn liczony jest dokładnie raz.
+ *
+ * Czas życia: trwałe (lvalue) argumenty węzeł trzyma przez referencję, więc a + b jest ważne tylko dopóki żyją
+ * a i b, a ich późniejsza zmiana zmienia wartość wyrażenia. Wynik należy od razu zamienić na Wielomian
+ * (Wielomian s = a + b;), a nie zapamiętywać przez auto. Węzeł udostępnia tylko stopien, toString i operator();
+ * pozostałe metody, a także warunek ?: z Wielomianem, wymagają jawnej zamiany. Węzła nie da się skopiować;
+ * nazwany węzeł użyty w kolejnej sumie jest najpierw materializowany.
+ */
+template <class L, class R, int Znak>
+struct [[nodiscard]] SumaWyrazen : WyrazenieWielomianowe<SumaWyrazen<L, R, Znak>> {
+    using Wspolczynnik = typename L::Wspolczynnik;
+
+    L l;
+    R r;
+
+    SumaWyrazen(L lewy, R prawy) : l(move(lewy)), r(move(prawy)) {}
+    SumaWyrazen(SumaWyrazen&&) = default;
+    SumaWyrazen(const SumaWyrazen&) = delete;
+    SumaWyrazen& operator=(const SumaWyrazen&) = delete;
+
+    size_t dlugosc() const { return max(l.dlugosc(), r.dlugosc()); }
+    bool wszystkieGeste() const { return l.wszystkieGeste() && r.wszystkieGeste(); }
+    bool wszystkieRzadkie() const { return l.wszystkieRzadkie() && r.wszystkieRzadkie(); }
+    Wspolczynnik operator[](size_t i) const { return Znak > 0 ? l[i] + r[i] : l[i] - r[i]; }
+    Wspolczynnik operator()(Wspolczynnik x) const { return Znak > 0 ? l(x) + r(x) : l(x) - r(x); }
+
+    void dodajDo(Wspolczynnik* out, Wspolczynnik znak) const {
+        l.dodajDo(out, znak);
+        r.dodajDo(out, Znak > 0 ? znak : -znak);
+    }
+
+    vector<pair<size_t, Wspolczynnik>> rzadkie(Wspolczynnik znak) const {
+        return detail::dodajRzadkie(l.rzadkie(znak), r.rzadkie(Znak > 0 ? znak : -znak), Wspolczynnik(1));
+    }
+};
+
+template <class T>
+struct jestWielomianem : false_type {};
+
+template <class T>
+struct jestWielomianem<Wielomian<T>> : true_type {};
+
+template <class T>
+concept ArgumentWyrazenia = jestWielomianem<remove_cvref_t<T>>::value || WezelWyrazenia<T>;
+
+/**
+ * Typ współczynników wielomianu albo wyrażenia.
+ */
+template <class T>
+using WspolczynnikWyrazenia = typename remove_cvref_t<T>::Wspolczynnik;
+
+/**
+ * Leniwe wyrażenie powstaje, gdy któryś argument jest już wyrażeniem albo oba są trwałymi obiektami;
+ * suma z ginącym Wielomianem liczona jest od razu w jego buforze (patrz przeciążenia dla Wielomian&&).
+ * Węzły wchodzą do drzewa tylko jako temporariusze: nazwany węzeł zamienia się na Wielomian i trafia do tamtych przeciążeń.
+ */
+template <class A, class B>
+concept LeniwaSuma = ArgumentWyrazenia<A> && ArgumentWyrazenia<B> &&
+    is_same_v<WspolczynnikWyrazenia<A>, WspolczynnikWyrazenia<B>> &&
+    !(WezelWyrazenia<A> && is_lvalue_reference_v<A>) && !(WezelWyrazenia<B> && is_lvalue_reference_v<B>) &&
+    (WezelWyrazenia<A> || WezelWyrazenia<B> || (is_lvalue_reference_v<A> && is_lvalue_reference_v<B>));
+
+/**
+ * Węzeł, którym argument staje się w drzewie wyrażenia.
+ */
+template <class T>
+auto wezelWyrazenia(T&& t) {
+    if constexpr (WezelWyrazenia<T>)
+        return remove_cvref_t<T>(forward<T>(t));
+    else if constexpr (is_lvalue_reference_v<T>)
+        return LiscWyrazenia<const remove_cvref_t<T>&>{ t };
+    else
+        return LiscWyrazenia<remove_cvref_t<T>>{ move(t) };
+}
+
+/**
+ * Operator dodawania dwóch wielomianów (lub wyrażeń) — zwraca leniwe wyrażenie.
+ */
+template <class A, class B>
+    requires LeniwaSuma<A, B>
+auto operator+(A&& a, B&& b) {
+    auto l = wezelWyrazenia(forward<A>(a));
+    auto r = wezelWyrazenia(forward<B>(b));
+    return SumaWyrazen<decltype(l), decltype(r), 1>(move(l), move(r));
+}
+
+/**
+ * Operator odejmowania dwóch wielomianów (lub wyrażeń) — zwraca leniwe wyrażenie.
+ */
+template <class A, class B>
+    requires LeniwaSuma<A, B>
+auto operator-(A&& a, B&& b) {
+    auto l = wezelWyrazenia(forward<A>(a));
+    auto r = wezelWyrazenia(forward<B>(b));
+    return SumaWyrazen<decltype(l), decltype(r), -1>(move(l), move(r));
+}
+
+/**
+ * Iloczyn, w którym co najmniej jeden czynnik jest wyrażeniem: czynniki materializowane są raz,
+ * a wynik jest zwykłym Wielomianem.
+ */
+template <ArgumentWyrazenia A, ArgumentWyrazenia B>
+    requires (WezelWyrazenia<A> || WezelWyrazenia<B>) && is_same_v<WspolczynnikWyrazenia<A>, WspolczynnikWyrazenia<B>>
+Wielomian<WspolczynnikWyrazenia<A>> operator*(const A& a, const B& b) {
+    using W = Wielomian<WspolczynnikWyrazenia<A>>;
+    if constexpr (WezelWyrazenia<A> && WezelWyrazenia<B>) return W(a) * W(b);
+    else if constexpr (WezelWyrazenia<A>) return W(a) * b;
+    else return a * W(b);
+}
+
+}
+
+/**
+ * Wielomian o współczynnikach double — typ używany w całej reszcie biblioteki.
+ */
+using Wielomian = wielomiany::Wielomian<double>;
+
+/**
+ * Wielomian stopnia N znanego w czasie kompilacji, o współczynnikach typu T trzymanych w std::array.
+ * Wszystko jest constexpr i nie alokuje; stopień sumy i iloczynu wynika z typów argumentów,
+ * a ewaluacja to Horner rozwinięty w czasie kompilacji. Zamienia się na Wielomian i z powrotem.
+ */
+template <size_t N, class T = double>
+class FixedWielomian {
+private:
+    array<T, N + 1> wsp{};  // Współczynniki, od wyrazu wolnego do x^N
+
+    template <size_t... I>
+    constexpr T horner([[maybe_unused]] T x, index_sequence<I...>) const {
+        T wynik = wsp[N];
+        ((wynik = wynik * x + wsp[N - 1 - I]), ...);
+        return wynik;
+    }
+
+public:
+    /**
+     * Wielomian zerowy.
+     */
+    constexpr FixedWielomian() = default;
+
+    /**
+     * Konstruktor z tablicy N + 1 współczynników, od wyrazu wolnego.
+     */
+    constexpr FixedWielomian(const array<T, N + 1>& wspolczynniki) : wsp(wspolczynniki) {}
+
+    /**
+     * Konstruktor z dokładnie N + 1 współczynników, np. FixedWielomian<2>(1, 2, 3) to 3x^2 + 2x + 1.
+     */
+    template <class... U>
+        requires (sizeof...(U) == N + 1 && (is_convertible_v<U, T> && ...))
+    constexpr FixedWielomian(U... wspolczynniki) : wsp{ T(wspolczynniki)... } {}
+
+    /**
+     * Tworzy wielomian z dynamicznego Wielomianu; rzuca wyjątek, jeśli jego stopień jest większy niż N.
+     */
+    template <class U>
+    static FixedWielomian zWielomianu(const wielomiany::Wielomian<U>& w) {
+        if (w.stopien() > int(N))
+            throw invalid_argument("Stopien wielomianu przekracza stopien FixedWielomian.");
+        FixedWielomian wynik;
+        for (size_t i = 0; i <= N; ++i) wynik.wsp[i] = T(w.wspolczynnik(i));
+        return wynik;
+    }
+
+    /**
+     * Zwraca stopień wielomianu (zawsze N).
+     */
+    static constexpr int stopien() { return N; }
+
+    constexpr const T& operator[](size_t i) const { return wsp[i]; }
+    constexpr T& operator[](size_t i) { return wsp[i]; }
+
+    /**
+     * Zwraca wartość wielomianu dla danego x (Horner rozwinięty w czasie kompilacji).
+     */
+    constexpr T operator()(T x) const { return horner(x, make_index_sequence<N>{}); }
+
+    /**
+     * Operator dodawania; wynik ma stopień max(N, M).
+     */
+    template <size_t M>
+    constexpr FixedWielomian<max(N, M), T> operator+(const FixedWielomian<M, T>& o) const {
+        FixedWielomian<max(N, M), T> wynik;
+        for (size_t i = 0; i <= N; ++i) wynik[i] += wsp[i];
+        for (size_t i = 0; i <= M; ++i) wynik[i] += o[i];
+        return wynik;
+    }
+
+    /**
+     * Operator odejmowania; wynik ma stopień max(N, M).
+     */
+    template <size_t M>
+    constexpr FixedWielomian<max(N, M), T> operator-(const FixedWielomian<M, T>& o) const {
+        FixedWielomian<max(N, M), T> wynik;
+        for (size_t i = 0; i <= N; ++i) wynik[i] += wsp[i];
+        for (size_t i = 0; i <= M; ++i) wynik[i] -= o[i];
+        return wynik;
+    }
+
+    /**
+     * Operator mnożenia; wynik ma stopień N + M.
+     */
+    template <size_t M>
+    constexpr FixedWielomian<N + M, T> operator*(const FixedWielomian<M, T>& o) const {
+        FixedWielomian<N + M, T> wynik;
+        for (size_t i = 0; i <= N; ++i)
+            for (size_t j = 0; j <= M; ++j)
+                wynik[i + j] += wsp[i] * o[j];
+        return wynik;
+    }
+
+    /**
+     * Zamiana na dynamiczny Wielomian o współczynnikach U, np. żeby dodać go do wielomianu nieznanego stopnia.
+     */
+    template <class U>
+        requires is_convertible_v<T, U>
+    operator wielomiany::Wielomian<U>() const {
+        vector<U> w(wsp.begin(), wsp.end());
+        return wielomiany::Wielomian<U>(w);
+    }
+
+    /**
+     * Zwraca tekstową reprezentację wielomianu (ten sam format co Wielomian::toString).
+     */
+    string toString() const { return wielomiany::Wielomian<T>(*this).toString(); }
+};
+
+namespace detail {
+    /**
+     * Pochodna szeregu f (n współczynników), skrócona do n - 1 współczynników.
+     */
+    template <class T>
+    vector<T> pochodnaSzeregu(const T* f, size_t n) {
+        vector<T> d(n > 0 ? n - 1 : 0);
+        for (size_t i = 1; i < n; ++i) d[i - 1] = f[i] * T(double(i));
+        return d;
+    }
+
+    /**
+     * Czy wyraz wolny leży w dziedzinie logarytmu i pierwiastka: dodatni dla liczb rzeczywistych,
+     * niezerowy dla zespolonych (gałąź główna).
+     */
+    template <class T>
+    bool wyrazWolnyWDziedzinie(const T& a) {
+        if constexpr (is_floating_point_v<T>) return a > 0;
+        else return a != T(0);
+    }
+
+    /**
+     * Logarytm szeregu modulo x^k: log f = log f[0] + całka(f' / f). Wymaga f[0] > 0 (zespolone: f[0] != 0).
+     */
+    template <class T>
+    vector<T> logSzeregu(const T* f, size_t n, size_t k) {
+        if (n == 0 || !wyrazWolnyWDziedzinie(f[0]))
+            throw domain_error("Logarytm szeregu wymaga dodatniego wyrazu wolnego.");
+        vector<T> wynik(k, T(0));
+        if (k == 0) return wynik;
+        wynik[0] = log(f[0]);
+        if (k == 1) return wynik;
+        vector<T> d = pochodnaSzeregu(f, min(n, k));
+        vector<T> odwr = odwrotnoscSzeregu(f, min(n, k - 1), k - 1);
+        vector<T> iloraz = iloczynKrotki(d.data(), d.size(), odwr.data(), odwr.size(), k - 1);
+        for (size_t i = 1; i < k; ++i) wynik[i] = iloraz[i - 1] / T(double(i));
+        return wynik;
+    }
+
+    /**
+     * Eksponenta szeregu modulo x^k iteracją Newtona g <- g(1 + f - log g), podwajającą liczbę poprawnych współczynników.
+     * Ponieważ log g = f (mod x^l), poprawka f - log g zaczyna się od x^l i wystarcza jej iloczyn krótki z g.
+     */
+    template <class T>
+    vector<T> expSzeregu(const T* f, size_t n, size_t k) {
+        vector<T> g;
+        if (k == 0) return g;
+        g.reserve(k);
+        g.push_back(exp(n > 0 ? f[0] : T(0)));
+        for (size_t l = 1; l < k;) {
+            size_t l2 = min(2 * l, k);
+            vector<T> lg = g;
+            lg.resize(l2, T(0));
+            lg = logSzeregu(lg.data(), l, l2);
+            vector<T> e(l2 - l);
+            for (size_t i = l; i < l2; ++i) e[i - l] = (i < n ? f[i] : T(0)) - lg[i];
+            vector<T> h = iloczynKrotki(g.data(), g.size(), e.data(), e.size(), l2 - l);
+            g.insert(g.end(), h.begin(), h.end());
+            l = l2;
+        }
+        return g;
+    }
+
+    /**
+     * Pierwiastek kwadratowy szeregu modulo x^k sprzężoną iteracją Newtona: razem z g = sqrt(f) mod x^l niesiona jest
+     * odwrotność h = 1/g mod x^l. Krok g <- g + h(f - g^2)/2 podwaja precyzję g, a jeden krok h <- h - h(gh - 1)
+     * z nowym g — precyzję h, więc na podwojenie przypadają cztery iloczyny długości l zamiast pełnej odwrotności.
+     * Wymaga f[0] > 0 (zespolone: f[0] != 0).
+     */
+    template <class T>
+    vector<T> sqrtSzeregu(const T* f, size_t n, size_t k) {
+        if (n == 0 || !wyrazWolnyWDziedzinie(f[0]))
+            throw domain_error("Pierwiastek szeregu wymaga dodatniego wyrazu wolnego.");
+        vector<T> g;
+        if (k == 0) return g;
+        g.reserve(k);
+        g.push_back(sqrt(f[0]));
+        vector<T> h{ T(1) / g[0] };
+        h.reserve(k);
+        for (size_t l = 1; l < k;) {
+            size_t l2 = min(2 * l, k);
+            // f - g^2 = x^l * E (mod x^l2), a poprawce h * E / 2 wystarcza l2 - l <= l współczynników h
+            vector<T> kwadrat = iloczynSrodkowy(g.data(), g.size(), g.data(), g.size(), l, l2 - l);
+            vector<T> e(l2 - l);
+            for (size_t i = l; i < l2; ++i) e[i - l] = ((i < n ? f[i] : T(0)) - kwadrat[i - l]) / T(2);
+            vector<T> poprawka = iloczynKrotki(h.data(), h.size(), e.data(), e.size(), l2 - l);
+            g.insert(g.end(), poprawka.begin(), poprawka.end());
+            if (l2 < k) {
+                // gh - 1 = x^l * E' (mod x^l2) dla nowego g; h dostaje kolejne l2 - l współczynników -hE'
+                vector<T> blad = iloczynSrodkowy(g.data(), g.size(), h.data(), h.size(), l, l2 - l);
+                vector<T> ph = iloczynKrotki(h.data(), h.size(), blad.data(), blad.size(), l2 - l);
+                for (T& c : ph) h.push_back(T(0) - c);
+            }
+            l = l2;
+        }
+        return g;
+    }
+}
+
+namespace wielomiany {
+
+/**
+ * Szereg potęgowy obcięty do ustalonego rzędu: przechowuje współczynniki przy x^0..x^(n-1), a wszystko od x^n wzwyż
+ * jest odrzucane (O(x^n)). Mnożenie liczy tylko potrzebne współczynniki (iloczyn krótki), a odwrotność, logarytm,
+ * eksponenta i pierwiastek działają iteracją Newtona w czasie O(M(n)). Wynik działania na szeregach
+ * różnych rzędów ma rząd mniejszy z nich.
+ *
+ * Współczynniki są przybliżone (float, double, long double albo complex): log, exp i sqrt wyrazu wolnego
+ * wymagają funkcji przestępnych, których LiczbaModulo nie ma.
+ */
+template <WspolczynnikPrzyblizony T = double>
+class SzeregPotegowy {
+private:
+    vector<T> wsp;      // dokładnie rzad() współczynników
+
+public:
+    /**
+     * Szereg zerowy rzędu n.
+     */
+    explicit SzeregPotegowy(size_t rzad) : wsp(rzad, T(0)) {}
+
+    /**
+     * Szereg o podanych współczynnikach, obcięty albo uzupełniony zerami do rzędu n.
+     */
+    SzeregPotegowy(vector<T> wspolczynniki, size_t rzad) : wsp(move(wspolczynniki)) {
+        wsp.resize(rzad, T(0));
+    }
+
+    /**
+     * Wielomian traktowany jako szereg rzędu n.
+     */
+    SzeregPotegowy(const Wielomian<T>& w, size_t rzad) : wsp(rzad, T(0)) {
+        for (size_t i = 0; i < rzad && int(i) <= w.stopien(); ++i) wsp[i] = w.wspolczynnik(i);
+    }
+
+    size_t rzad() const { return wsp.size(); }
+
+    T operator[](size_t i) const { return wsp[i]; }
+
+    span<const T> wspolczynniki() const { return wsp; }
+
+    /**
+     * Obcięcie szeregu jako wielomian stopnia co najwyżej rzad() - 1.
+     */
+    Wielomian<T> naWielomian() const {
+        if (wsp.empty()) return Wielomian<T>({ T(0) });
+        return Wielomian<T>(span<const T>(wsp));
+    }
+
+    /**
+     * Zwraca tekstową reprezentację: obcięty wielomian i człon O(x^n).
+     */
+    string toString() const {
+        stringstream ss;
+        ss << naWielomian().toString() << " + O(x^" << rzad() << ")";
+        return ss.str();
+    }
+
+    /**
+     * Iloczyn krótki: pierwsze k współczynników a * b.
+     */
+    static vector<T> iloczynKrotki(span<const T> a, span<const T> b, size_t k) {
+        return detail::iloczynKrotki(a.data(), a.size(), b.data(), b.size(), k);
+    }
+
+    /**
+     * Iloczyn środkowy: współczynniki [od, od + ile) a * b, bez liczenia pozostałych tam, gdzie pozwala na to FFT.
+     */
+    static vector<T> iloczynSrodkowy(span<const T> a, span<const T> b, size_t od, size_t ile) {
+        return detail::iloczynSrodkowy(a.data(), a.size(), b.data(), b.size(), od, ile);
+    }
+
+    SzeregPotegowy& operator+=(const SzeregPotegowy& o) {
+        wsp.resize(min(rzad(), o.rzad()));
+        for (size_t i = 0; i < wsp.size(); ++i) wsp[i] += o.wsp[i];
+        return *this;
+    }
+
+    SzeregPotegowy& operator-=(const SzeregPotegowy& o) {
+        wsp.resize(min(rzad(), o.rzad()));
+        for (size_t i = 0; i < wsp.size(); ++i) wsp[i] -= o.wsp[i];
+        return *this;
+    }
+
+    SzeregPotegowy& operator*=(const SzeregPotegowy& o) {
+        size_t n = min(rzad(), o.rzad());
+        wsp = detail::iloczynKrotki(wsp.data(), wsp.size(), o.wsp.data(), o.wsp.size(), n);
+        return *this;
+    }
+
+    SzeregPotegowy& operator*=(T c) {
+        for (T& x : wsp) x *= c;
+        return *this;
+    }
+
+    friend SzeregPotegowy operator+(SzeregPotegowy a, const SzeregPotegowy& b) { return a += b; }
+    friend SzeregPotegowy operator-(SzeregPotegowy a, const SzeregPotegowy& b) { return a -= b; }
+    friend SzeregPotegowy operator*(SzeregPotegowy a, const SzeregPotegowy& b) { return a *= b; }
+    friend SzeregPotegowy operator*(SzeregPotegowy a, T c) { return a *= c; }
+    friend SzeregPotegowy operator*(T c, SzeregPotegowy a) { return a *= c; }
+
+    /**
+     * Odwrotność 1 / f. Wymaga niezerowego wyrazu wolnego.
+     */
+    SzeregPotegowy odwrotnosc() const {
+        if (wsp.empty()) return *this;
+        return SzeregPotegowy(detail::odwrotnoscSzeregu(wsp.data(), wsp.size(), rzad()), rzad());
+    }
+
+    /**
+     * Logarytm naturalny. Wymaga dodatniego wyrazu wolnego (dla zespolonych: niezerowego, gałąź główna).
+     */
+    SzeregPotegowy log() const {
+        return SzeregPotegowy(detail::logSzeregu(wsp.data(), wsp.size(), rzad()), rzad());
+    }
+
+    /**
+     * Eksponenta.
+     */
+    SzeregPotegowy exp() const {
+        return SzeregPotegowy(detail::expSzeregu(wsp.data(), wsp.size(), rzad()), rzad());
+    }
+
+    /**
+     * Pierwiastek kwadratowy o dodatnim wyrazie wolnym. Wymaga dodatniego wyrazu wolnego (dla zespolonych: niezerowego).
+     */
+    SzeregPotegowy sqrt() const {
+        return SzeregPotegowy(detail::sqrtSzeregu(wsp.data(), wsp.size(), rzad()), rzad());
+    }
+};
+
+}
+
+/**
+ * Szereg potęgowy o współczynnikach double, odpowiednik Wielomian.
  */
-class Wielomian {
+using SzeregPotegowy = wielomiany::SzeregPotegowy<double>;
+
+/**
+ * Wielomian o współczynnikach z ciała GF(P), liczony dokładnie. Mnożenie powyżej ProgiMnozenia::ntt idzie przez NTT,
+ * dzielenie — przez odwrotność Newtona, a NWD — przez pół-NWD; toString wypisuje współczynniki z [0, P).
+ */
+template <uint32_t P>
+using WielomianModulo = wielomiany::Wielomian<LiczbaModulo<P>>;
+
+/**
+ * Dokładny iloczyn wielomianów o współczynnikach całkowitych (NTT modulo kilku liczb pierwszych i CRT).
+ * Rzuca overflow_error, gdy któryś współczynnik wyniku nie mieści się w long long.
+ */
+inline vector<long long> iloczynCalkowity(span<const long long> a, span<const long long> b) {
+    if (a.empty() || b.empty()) return {};
+    vector<__int128> dokladny;
+    if (!detail::mnozCalkowite(a.data(), a.size(), b.data(), b.size(), dokladny))
+        throw overflow_error("Iloczyn jest za duzy dla rekonstrukcji CRT.");
+    vector<long long> wynik(dokladny.size());
+    for (size_t i = 0; i < wynik.size(); ++i) {
+        if (dokladny[i] > numeric_limits<long long>::max() || dokladny[i] < numeric_limits<long long>::min())
+            throw overflow_error("Wspolczynnik iloczynu nie miesci sie w long long.");
+        wynik[i] = (long long)dokladny[i];
+    }
+    return wynik;
+}
+
+/**
+ * Widok wielomianu leżącego w cudzym buforze (np. w pliku zmapowanym przez PolynomialStore): nie kopiuje
+ * ani nie posiada współczynników, więc jest ważny tylko dopóki żyje bufor. Współczynniki są w kolejności little-endian;
+ * na takim procesorze wartości liczone są wprost z bufora, tymi samymi jądrami co w Wielomian.
+ */
+template <detail::WspolczynnikBinarny T = double>
+class WielomianView {
 private:
-    vector<double> wsp;  // Współczynniki wielomianu, od wyrazu wolnego do najwyższego stopnia
+    const T* wsp;
+    size_t n;
 
 public:
+    WielomianView(const T* wspolczynniki, size_t dlugosc) : wsp(wspolczynniki), n(dlugosc) {}
+
+    int stopien() const { return int(n) - 1; }
+
     /**
-     * Konstruktor tworzący wielomian na podstawie wektora współczynników.
-     * Usuwa zbędne zera z końca i sprawdza, czy wielomian nie jest pusty.
+     * Zwraca współczynnik przy x^i (0 powyżej stopnia).
      */
-    Wielomian(const vector<double>& wspolczynniki) : wsp(wspolczynniki) {
-        if (wsp.empty())
-            throw invalid_argument("Wielomian nie moze byc pusty.");
+    T wspolczynnik(size_t i) const { return i < n ? detail::littleEndian(wsp[i]) : T(0); }
 
-        while (wsp.size() > 1 && abs(wsp.back()) < 0.0)
-            wsp.pop_back();
+    /**
+     * Wartość w punkcie x, tym samym schematem co Wielomian::operator() ze schematem Auto.
+     */
+    T operator()(T x) const {
+        if constexpr (endian::native == endian::little) {
+            SchematEwaluacji schemat = stopien() < wielomiany::Wielomian<T>::progEstrina ? SchematEwaluacji::Horner : SchematEwaluacji::Hybryda;
+            return detail::wartosc(wsp, n, x, schemat);
+        }
+        else {
+            T wynik = T(0);
+            for (size_t i = n; i-- > 0;) wynik = wynik * x + wspolczynnik(i);
+            return wynik;
+        }
     }
 
     /**
-     * Zwraca stopień wielomianu.
+     * Wartości w wielu punktach naraz: out[i] = W(xs[i]) (patrz Wielomian::evaluate).
      */
-    int stopien() const {
-        return wsp.size() - 1;
+    void evaluate(span<const T> xs, span<T> out) const {
+        if (xs.size() != out.size())
+            throw invalid_argument("Liczba punktow i wynikow musi byc rowna.");
+        if constexpr (endian::native == endian::little)
+            detail::hornerWielu(wsp, n, xs.data(), out.data(), xs.size());
+        else
+            for (size_t i = 0; i < xs.size(); ++i) out[i] = (*this)(xs[i]);
     }
 
     /**
-     * Zwraca tekstową reprezentację wielomianu w formie np. "W(x) = 3x^2 + 2x + 1".
+     * Kopiuje współczynniki do zwykłego Wielomianu.
      */
-    string toString() const {
-        ostringstream oss;  // dodane przez chatGPT
-        oss << "W(x) = ";
-        bool pierwsze = true;
+    wielomiany::Wielomian<T> naWielomian() const {
+        vector<T> w(n);
+        for (size_t i = 0; i < n; ++i) w[i] = wspolczynnik(i);
+        return wielomiany::Wielomian<T>(w);
+    }
+
+    string toString() const { return naWielomian().toString(); }
+};
 
-        for (int i = stopien(); i >= 0; --i) {
-            double c = wsp[i];
-            if (abs(c) < 0.0) continue;
+namespace detail {
+    inline constexpr char magiaMagazynu[8] = { 'W', 'I', 'E', 'L', 'O', 'M', 'B', '1' };
+    inline constexpr size_t naglowekMagazynu = 32;     // magia, kod typu, zarezerwowane, liczba wielomianów, położenie indeksu
 
-            if (!pierwsze) oss << (c >= 0 ? " + " : " - ");
-            else if (c < 0) oss << "-";
+    inline uint64_t czytajU64(const byte* p) {
+        uint64_t x;
+        memcpy(&x, p, sizeof x);
+        return littleEndian(x);
+    }
+}
+
+/**
+ * Zapisuje plik czytany przez PolynomialStore: nagłówek, kolejne rekordy zapiszBinarnie, a na końcu indeks
+ * położeń rekordów (uint64 little-endian), dzięki któremu odczyt ma swobodny dostęp bez przeglądania pliku.
+ * Rekordy są strumieniowane na dysk; w pamięci zostaje tylko indeks (8 bajtów na wielomian).
+ */
+template <detail::WspolczynnikBinarny T = double>
+class PolynomialStoreWriter {
+private:
+    ofstream plik;
+    vector<uint64_t> polozenia;
+    uint64_t pozycja = detail::naglowekMagazynu;
+    bool zamkniety = false;
+
+    void zapiszNaglowek(uint64_t polozenieIndeksu) {
+        uint32_t kod = detail::littleEndian(detail::kodTypuBinarnego<T>()), zarezerwowane = 0;
+        uint64_t liczba = detail::littleEndian(uint64_t(polozenia.size()));
+        polozenieIndeksu = detail::littleEndian(polozenieIndeksu);
+        plik.write(detail::magiaMagazynu, sizeof detail::magiaMagazynu);
+        plik.write(reinterpret_cast<const char*>(&kod), sizeof kod);
+        plik.write(reinterpret_cast<const char*>(&zarezerwowane), sizeof zarezerwowane);
+        plik.write(reinterpret_cast<const char*>(&liczba), sizeof liczba);
+        plik.write(reinterpret_cast<const char*>(&polozenieIndeksu), sizeof polozenieIndeksu);
+    }
+
+public:
+    explicit PolynomialStoreWriter(const string& sciezka) : plik(sciezka, ios::binary | ios::trunc) {
+        if (!plik) throw runtime_error("Nie mozna otworzyc pliku wielomianow do zapisu.");
+        zapiszNaglowek(0);
+    }
+
+    PolynomialStoreWriter(const PolynomialStoreWriter&) = delete;
+    PolynomialStoreWriter& operator=(const PolynomialStoreWriter&) = delete;
+
+    /**
+     * Zamyka plik, jeśli nie zrobiono tego wcześniej; błędy zapisu są tu pomijane — aby je zobaczyć, należy wywołać zamknij().
+     */
+    ~PolynomialStoreWriter() {
+        try { zamknij(); }
+        catch (...) {}
+    }
+
+    /**
+     * Dopisuje wielomian; jego numer w PolynomialStore to liczba wcześniej dodanych.
+     */
+    void dodaj(const wielomiany::Wielomian<T>& w) {
+        if (zamkniety) throw logic_error("Plik wielomianow jest juz zamkniety.");
+        polozenia.push_back(pozycja);
+        pozycja += w.zapiszBinarnie(plik);
+    }
+
+    /**
+     * Zapisuje indeks i uzupełnia nagłówek. Bez tego plik nie nadaje się do odczytu.
+     */
+    void zamknij() {
+        if (zamkniety) return;
+        zamkniety = true;
+        for (uint64_t& p : polozenia) p = detail::littleEndian(p);
+        plik.write(reinterpret_cast<const char*>(polozenia.data()), streamsize(polozenia.size() * sizeof(uint64_t)));
+        plik.seekp(0);
+        zapiszNaglowek(pozycja);
+        plik.close();
+        if (!plik) throw runtime_error("Blad zapisu pliku wielomianow.");
+    }
+};
+
+/**
+ * Plik wielomianów tylko do odczytu, zmapowany do pamięci: operator[] zwraca WielomianView wskazujący prosto
+ * na współczynniki w pliku, bez kopiowania i bez wczytywania całości (strony doczytuje system przy pierwszym dostępie).
+ * Sprawdzany jest nagłówek i zgodność typu współczynników; granice rekordu — przy każdym dostępie.
+ * Na systemach bez mmap plik wczytywany jest do pamięci w całości.
+ */
+template <detail::WspolczynnikBinarny T = double>
+class PolynomialStore {
+private:
+    const byte* dane = nullptr;
+    size_t rozmiar = 0;
+    vector<byte> kopia;             // zawartość pliku, gdy nie ma mmap
+    size_t liczba = 0;
+    uint64_t polozenieIndeksu = 0;
+
+    void zwolnij() {
+#ifdef WIELOMIAN_MMAP
+        if (dane && kopia.empty()) munmap(const_cast<byte*>(dane), rozmiar);
+#endif
+        dane = nullptr;
+    }
+
+    void sprawdzNaglowek() {
+        if (rozmiar < detail::naglowekMagazynu || memcmp(dane, detail::magiaMagazynu, sizeof detail::magiaMagazynu) != 0)
+            throw runtime_error("To nie jest plik wielomianow.");
+        uint32_t kod;
+        memcpy(&kod, dane + 8, sizeof kod);
+        if (detail::littleEndian(kod) != detail::kodTypuBinarnego<T>())
+            throw runtime_error("Plik zawiera wielomiany o innym typie wspolczynnikow.");
+        uint64_t n = detail::czytajU64(dane + 16);
+        polozenieIndeksu = detail::czytajU64(dane + 24);
+        if (polozenieIndeksu < detail::naglowekMagazynu || polozenieIndeksu > rozmiar || n > (rozmiar - polozenieIndeksu) / 8)
+            throw runtime_error("Uszkodzony plik wielomianow.");
+        liczba = size_t(n);
+    }
+
+public:
+    explicit PolynomialStore(const string& sciezka) {
+#ifdef WIELOMIAN_MMAP
+        int fd = open(sciezka.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("Nie mozna otworzyc pliku wielomianow.");
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("Nie mozna odczytac rozmiaru pliku wielomianow.");
+        }
+        rozmiar = size_t(info.st_size);
+        void* mapa = rozmiar ? mmap(nullptr, rozmiar, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapa == MAP_FAILED) throw runtime_error("Nie mozna zmapowac pliku wielomianow.");
+        dane = static_cast<const byte*>(mapa);
+#else
+        ifstream plik(sciezka, ios::binary);
+        if (!plik) throw runtime_error("Nie mozna otworzyc pliku wielomianow.");
+        plik.seekg(0, ios::end);
+        rozmiar = size_t(plik.tellg());
+        plik.seekg(0);
+        kopia.resize(rozmiar);
+        if (!plik.read(reinterpret_cast<char*>(kopia.data()), streamsize(rozmiar)))
+            throw runtime_error("Nie mozna odczytac pliku wielomianow.");
+        dane = kopia.data();
+#endif
+        try { sprawdzNaglowek(); }
+        catch (...) {
+            zwolnij();
+            throw;
+        }
+    }
+
+    PolynomialStore(const PolynomialStore&) = delete;
+    PolynomialStore& operator=(const PolynomialStore&) = delete;
+    ~PolynomialStore() { zwolnij(); }
+
+    /**
+     * Liczba wielomianów w pliku.
+     */
+    size_t size() const { return liczba; }
+
+    /**
+     * Widok i-tego wielomianu, ważny dopóki istnieje ten obiekt.
+     */
+    WielomianView<T> operator[](size_t i) const {
+        if (i >= liczba) throw out_of_range("Numer wielomianu poza plikiem.");
+        uint64_t p = detail::czytajU64(dane + polozenieIndeksu + 8 * i);
+        if (p < detail::naglowekMagazynu || p % 8 != 0 || p + 8 > polozenieIndeksu)
+            throw runtime_error("Uszkodzony plik wielomianow.");
+        uint64_t n = detail::czytajU64(dane + p);
+        if (n == 0 || n > (polozenieIndeksu - p - 8) / sizeof(T))
+            throw runtime_error("Uszkodzony plik wielomianow.");
+        return WielomianView<T>(reinterpret_cast<const T*>(dane + p + 8), size_t(n));
+    }
+};
+
+namespace detail {
+    /**
+     * Poddrzewa iloczynu o mniejszej łącznej liczbie współczynników liczone są w jednym wątku.
+     */
+    inline size_t progIloczynuRownoleglego = 512;
+
+    /**
+     * Iloczyn czynników [od, do) drzewem zrównoważonym według stopnia: podział tam, gdzie suma długości
+     * (sumy[i] = łączna długość czynników przed i) osiąga połowę. Lewe poddrzewo idzie do puli, prawe liczy
+     * bieżący wątek. Algorytm mnożenia dobiera detail::mnoz według długości czynników, więc wraz z poziomem
+     * drzewa przechodzi od mnożenia szkolnego przez Karatsubę do FFT/NTT.
+     */
+    template <class W>
+    W iloczynDrzewem(const vector<const W*>& czynniki, const vector<size_t>& sumy, size_t od, size_t do_, PulaZadan* pula) {
+        if (do_ - od == 1) return *czynniki[od];
+        size_t polowa = (sumy[od] + sumy[do_]) / 2;
+        size_t srodek = size_t(lower_bound(sumy.begin() + od + 1, sumy.begin() + do_, polowa) - sumy.begin());
+        srodek = clamp(srodek, od + 1, do_ - 1);
+
+        if (!pula || sumy[do_] - sumy[od] < progIloczynuRownoleglego)
+            return iloczynDrzewem(czynniki, sumy, od, srodek, nullptr) * iloczynDrzewem(czynniki, sumy, srodek, do_, nullptr);
+
+        optional<W> lewy, prawy;
+        GrupaZadan grupa;
+        pula->uruchom(grupa, [&] { lewy.emplace(iloczynDrzewem(czynniki, sumy, od, srodek, pula)); });
+        try {
+            prawy.emplace(iloczynDrzewem(czynniki, sumy, srodek, do_, pula));
+        }
+        catch (...) {
+            try { pula->czekaj(grupa); }    // zadanie odwołuje się do tej ramki stosu
+            catch (...) {}
+            throw;
+        }
+        pula->czekaj(grupa);
+        return move(*lewy) * move(*prawy);
+    }
+}
+
+/**
+ * Iloczyn wszystkich wielomianów z zakresu (pusty zakres daje 1) zrównoważonym drzewem iloczynów:
+ * O(M(n) log k) zamiast O(n^2) przy mnożeniu po kolei, gdzie n to stopień wyniku, a k liczba czynników.
+ * Niezależne poddrzewa liczone są równolegle na puli z kradzieżą zadań (domyślnie detail::PulaZadan::globalna()).
+ */
+template <ranges::forward_range R>
+    requires wielomiany::jestWielomianem<ranges::range_value_t<R>>::value
+ranges::range_value_t<R> productOf(R&& zakres, detail::PulaZadan& pula = detail::PulaZadan::globalna()) {
+    using W = ranges::range_value_t<R>;
+    vector<const W*> czynniki;
+    vector<size_t> sumy{ 0 };
+    for (const W& w : zakres) {
+        czynniki.push_back(&w);
+        sumy.push_back(sumy.back() + size_t(w.stopien() + 1));
+    }
+    if (czynniki.empty()) return W{ typename W::Wspolczynnik(1) };
+    return detail::iloczynDrzewem(czynniki, sumy, 0, czynniki.size(), pula.rozmiar() > 1 ? &pula : nullptr);
+}
 
+namespace detail {
+    /**
+     * Najmniejsza łączna liczba współczynników na wątek w sumOf; mniejsze sumy liczone są w jednym buforze.
+     */
+    inline size_t progSumyRownoleglej = 1 << 15;
+}
+
+/**
+ * Suma wszystkich wielomianów z zakresu (pusty zakres daje 0), bez alokacji na każdy składnik.
+ * Zakres dzielony jest na ciągłe części o zbliżonej łącznej długości; każdy wątek sumuje swoją część do własnego
+ * bufora długości najdłuższego składnika, a bufory łączone są parami w drzewie. Gęste współczynniki dodawane są
+ * przez detail::dodajWektory. Kolejność dodawania zależy od liczby wątków, więc dla liczb zmiennoprzecinkowych
+ * wynik może różnić się od sumowania kolejnego o błąd zaokrągleń.
+ */
+template <ranges::forward_range R>
+    requires wielomiany::jestWielomianem<ranges::range_value_t<R>>::value
+ranges::range_value_t<R> sumOf(R&& zakres, detail::PulaWatkow& pula = detail::PulaWatkow::globalna()) {
+    using W = ranges::range_value_t<R>;
+    using T = typename W::Wspolczynnik;
+    vector<const W*> skladniki;
+    vector<size_t> sumy{ 0 };
+    size_t dlugosc = 1;
+    for (const W& w : zakres) {
+        size_t n = size_t(w.stopien()) + 1;
+        skladniki.push_back(&w);
+        sumy.push_back(sumy.back() + n);
+        dlugosc = max(dlugosc, n);
+    }
+    if (skladniki.empty()) return W{ T(0) };
+
+    size_t czesci = min({ pula.rozmiar(), skladniki.size(), max<size_t>(sumy.back() / detail::progSumyRownoleglej, 1) });
+    vector<size_t> granice(czesci + 1, skladniki.size());
+    for (size_t j = 0; j < czesci; ++j)
+        granice[j] = size_t(lower_bound(sumy.begin(), sumy.end(), sumy.back() / czesci * j) - sumy.begin());
+
+    vector<vector<T>> bufory(czesci);
+    pula.rownolegle(czesci, [&](size_t j) {
+        bufory[j].assign(dlugosc, T(0));    // alokacja w wątku, który będzie z bufora korzystał
+        for (size_t i = granice[j]; i < granice[j + 1]; ++i)
+            wielomiany::LiscWyrazenia<const W&>{ *skladniki[i] }.dodajDo(bufory[j].data(), T(1));
+    });
+    for (size_t krok = 1; krok < czesci; krok *= 2)
+        pula.rownolegle((czesci + krok - 1) / (2 * krok), [&](size_t p) {
+            size_t j = 2 * krok * p;
+            detail::dodajWektory(bufory[j].data(), bufory[j + krok].data(), dlugosc);
+            vector<T>().swap(bufory[j + krok]);
+        });
+    return W(bufory[0]);
+}
+
+#ifdef WIELOMIAN_BENCHMARK
+static size_t licznikAlokacji = 0;   // liczba wywołań operator new, zliczana tylko w benchmarkach
+
+void* operator new(size_t n) {
+    ++licznikAlokacji;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+// GCC inlinuje zwolnienia z funkcji zdefiniowanych wyżej, zanim zobaczy tę wymianę operatora new, i błędnie zgłasza niezgodność z free
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+#pragma GCC diagnostic pop
+
+/**
+ * Liczy alokacje i czas dla tworzenia, kopiowania i dodawania wielomianów stopnia 7
+ * (mieszczących się w buforze lokalnym) oraz, dla porównania, tych samych operacji na vector<double>.
+ */
+void benchmarkAlokacji() {
+    const size_t ile = 100000;
+    volatile double ujscie = 0;
+
+    auto zmierz = [&](const char* nazwa, auto&& f) {
+        size_t przed = licznikAlokacji;
+        auto start = chrono::steady_clock::now();
+        f();
+        chrono::duration<double, milli> czas = chrono::steady_clock::now() - start;
+        cout << nazwa << ": " << double(licznikAlokacji - przed) / ile << " alokacji/op, " << czas.count() << " ms" << endl;
+    };
+
+    vector<Wielomian> wielomiany;
+    wielomiany.reserve(ile);
+    zmierz("Wielomian tworzenie      ", [&] {
+        for (size_t i = 0; i < ile; ++i) wielomiany.push_back(Wielomian({ 1, 2, 3, 4, 5, 6, 7, double(i) }));
+    });
+    zmierz("Wielomian kopiowanie     ", [&] {
+        vector<Wielomian> kopia = wielomiany;
+        ujscie = ujscie + kopia.back()(1.0);
+    });
+    zmierz("Wielomian dodawanie      ", [&] {
+        for (size_t i = 1; i < ile; ++i) {
+            Wielomian suma = wielomiany[i] + wielomiany[i - 1];
+            ujscie = ujscie + suma(1.0);
+        }
+    });
+
+    vector<vector<double>> wektory;
+    wektory.reserve(ile);
+    zmierz("vector<double> tworzenie ", [&] {
+        for (size_t i = 0; i < ile; ++i) wektory.push_back({ 1, 2, 3, 4, 5, 6, 7, double(i) });
+    });
+    zmierz("vector<double> kopiowanie", [&] {
+        vector<vector<double>> kopia = wektory;
+        ujscie = ujscie + kopia.back()[0];
+    });
+    zmierz("vector<double> dodawanie ", [&] {
+        for (size_t i = 1; i < ile; ++i) {
+            vector<double> suma(wektory[i]);
+            for (size_t j = 0; j < suma.size(); ++j) suma[j] += wektory[i - 1][j];
+            ujscie = ujscie + suma[0];
+        }
+    });
+}
+
+/**
+ * Porównuje czas jednej ewaluacji Hornerem, Estrinem i schematem hybrydowym dla rosnących stopni
+ * i wypisuje stopień, od którego Horner przestaje być najszybszy (kandydat na Wielomian::progEstrina).
+ * Kompilacja: g++ -O2 -std=c++20 -DWIELOMIAN_BENCHMARK Zad1.cpp
+ */
+void benchmarkEwaluacji() {
+    const SchematEwaluacji schematy[] = { SchematEwaluacji::Horner, SchematEwaluacji::Estrin, SchematEwaluacji::Hybryda };
+    volatile double ujscie = 0;
+    int przeciecie = -1;
+
+    cout << "stopien   Horner[ns]   Estrin[ns]   Hybryda[ns]" << endl;
+    for (int st : { 2, 4, 8, 12, 16, 24, 32, 48, 64, 128, 256, 1024 }) {
+        vector<double> c(st + 1);
+        for (int i = 0; i <= st; ++i) c[i] = 1.0 / (i + 1);
+        Wielomian w(c);
+
+        double czasy[3];
+        for (int k = 0; k < 3; ++k) {
+            w.ustawSchemat(schematy[k]);
+            czasy[k] = detail::zmierzCzas([&] {
+                double s = 0;
+                for (int p = 0; p < 64; ++p) s += w(0.5 + p * 1e-3);
+                ujscie = ujscie + s;
+            }) / 64 * 1e9;
+        }
+        cout << st << "\t" << czasy[0] << "\t" << czasy[1] << "\t" << czasy[2] << endl;
+        if (przeciecie < 0 && min(czasy[1], czasy[2]) < czasy[0]) przeciecie = st;
+    }
+    cout << "Horner przestaje byc najszybszy od stopnia: " << przeciecie << endl;
+}
+
+/**
+ * Porównuje dawny toString (ostringstream i to_string dla każdego wykładnika) z toString i appendTo
+ * opartymi na to_chars, dla wielomianów stopnia 7 i 100. appendTo dopisuje do jednego napisu jak przy zrzucie do logu.
+ */
+void benchmarkFormatowania() {
+    auto przezStrumien = [](const Wielomian& w) {
+        ostringstream oss;
+        oss << "W(x) = ";
+        for (int i = w.stopien(); i >= 0; --i) {
+            double c = w.wspolczynnik(i);
+            if (i < w.stopien()) oss << (c >= 0 ? " + " : " - ");
+            else if (c < 0) oss << "-";
             if (abs(c) != 1 || i == 0) oss << abs(c);
             if (i > 0) oss << "x" << (i > 1 ? "^" + to_string(i) : "");
+        }
+        return oss.str();
+    };
+
+    for (int st : { 7, 100 }) {
+        const size_t ile = 200000 / (st + 1);
+        vector<Wielomian> wielomiany;
+        for (size_t k = 0; k < ile; ++k) {
+            vector<double> c(st + 1);
+            for (int i = 0; i <= st; ++i) c[i] = (i % 3 ? -1.0 : 1.0) * (k + 1) / (i + 3);
+            wielomiany.emplace_back(c);
+        }
+
+        volatile size_t ujscie = 0;
+        double strumien = detail::zmierzCzas([&] { for (const Wielomian& w : wielomiany) ujscie = ujscie + przezStrumien(w).size(); });
+        double napis = detail::zmierzCzas([&] { for (const Wielomian& w : wielomiany) ujscie = ujscie + w.toString().size(); });
+        string log;
+        double dopisanie = detail::zmierzCzas([&] {
+            log.clear();
+            for (const Wielomian& w : wielomiany) {
+                w.appendTo(log);
+                log += '\n';
+            }
+            ujscie = ujscie + log.size();
+        });
+        cout << "stopien " << st << ": ostringstream " << strumien / ile * 1e9 << " ns, toString " << napis / ile * 1e9
+             << " ns, appendTo " << dopisanie / ile * 1e9 << " ns na wielomian"
+             << (przezStrumien(wielomiany.back()) == wielomiany.back().toString() ? "" : " (ROZNE WYNIKI)") << endl;
+    }
+}
+
+/**
+ * Przepustowość Wielomian::parsuj na tekstach z toString (stopnie 2..9), parsowanych do jednego obiektu.
+ */
+void benchmarkParsowania() {
+    vector<string> teksty;
+    for (size_t k = 0; k < 4096; ++k) {
+        vector<double> c(3 + k % 8);
+        for (size_t i = 0; i < c.size(); ++i) c[i] = (i % 2 ? -1.0 : 1.0) * double(k + i) / 8;
+        teksty.push_back(Wielomian(c).toString());
+    }
+
+    Wielomian cel{ 0 };
+    volatile size_t ujscie = 0;
+    double czas = detail::zmierzCzas([&] {
+        for (const string& t : teksty) ujscie = ujscie + !Wielomian::parsuj(t, cel);
+    });
+    cout << "parsuj: " << teksty.size() / czas / 1e6 << " mln wielomianow/s" << endl;
+}
+
+/**
+ * Porównuje mnożenie wielu czynników liniowych kolejno (*=) z drzewem iloczynów productOf.
+ */
+void benchmarkIloczynuWielu() {
+    vector<Wielomian> czynniki;
+    for (size_t i = 0; i < 8192; ++i) czynniki.push_back(Wielomian{ double(i % 97) / 97 - 0.5, 1.0 });
+
+    Wielomian kolejno{ 1 }, drzewem{ 1 };
+    double czasKolejno = detail::zmierzCzas([&] {
+        kolejno = Wielomian{ 1 };
+        for (const Wielomian& c : czynniki) kolejno *= c;
+    });
+    double czasDrzewem = detail::zmierzCzas([&] { drzewem = productOf(czynniki); });
+    cout << "iloczyn " << czynniki.size() << " czynnikow: kolejno " << czasKolejno * 1e3 << " ms, productOf "
+         << czasDrzewem * 1e3 << " ms (watki: " << detail::PulaZadan::globalna().rozmiar() << ")" << endl;
+}
+
+/**
+ * Porównuje sumowanie wielu wielomianów przez += z równoległym sumOf.
+ */
+void benchmarkSumowania() {
+    vector<Wielomian> skladniki;
+    for (size_t k = 0; k < 100000; ++k) {
+        vector<double> c(1 + k % 64);
+        for (size_t i = 0; i < c.size(); ++i) c[i] = double((k * 31 + i) % 17) - 8;
+        skladniki.emplace_back(c);
+    }
+
+    Wielomian kolejno{ 0 }, rownolegle{ 0 };
+    double czasKolejno = detail::zmierzCzas([&] {
+        kolejno = Wielomian{ 0 };
+        for (const Wielomian& s : skladniki) kolejno += s;
+    });
+    double czasRownolegle = detail::zmierzCzas([&] { rownolegle = sumOf(skladniki); });
+    cout << "suma " << skladniki.size() << " wielomianow: += " << czasKolejno * 1e3 << " ms, sumOf "
+         << czasRownolegle * 1e3 << " ms (watki: " << detail::PulaWatkow::globalna().rozmiar() << ")" << endl;
+}
+
+/**
+ * Rekurencja Millera a potęgowanie binarne nad GF(p) i dla int64 (t — liczba niezerowych wyrazów poza wolnym);
+ * na tej podstawie dobrane są detail::progMillera i warunek w detail::oplacaSieMiller.
+ */
+void benchmarkPotegowania() {
+    using F = LiczbaModulo<998244353>;
+    for (size_t t : { 1, 4, 16, 64 }) {
+        cout << "potega GF(p), t = " << t << ":";
+        for (unsigned e : { 16u, 256u, 4096u }) {
+            vector<F> w(t + 1);
+            for (size_t i = 0; i <= t; ++i) w[i] = F((long long)(i * 7 + 3));
+            volatile uint32_t ujscie = 0;
+            double miller = detail::zmierzCzas([&] { ujscie = ujscie + detail::potegaMillera(w.data(), w.size(), e)[1].wartosc(); });
+            double binarnie = detail::zmierzCzas([&] { ujscie = ujscie + detail::potegaBinarna(w.data(), w.size(), e)[1].wartosc(); });
+            cout << "  e = " << e << ": Miller " << miller * 1e3 << " ms, binarnie " << binarnie * 1e3 << " ms";
+        }
+        cout << endl;
+    }
+    for (size_t t : { 4, 16, 64 }) {
+        cout << "potega int64, t = " << t << ":";
+        for (unsigned e : { 4u, 8u }) {
+            vector<int64_t> w(t + 1, 1);
+            volatile int64_t ujscie = 0;
+            double miller = detail::zmierzCzas([&] { ujscie = ujscie + detail::potegaMillera(w.data(), w.size(), e)[1]; });
+            double binarnie = detail::zmierzCzas([&] { ujscie = ujscie + detail::potegaBinarna(w.data(), w.size(), e)[1]; });
+            cout << "  e = " << e << ": Miller " << miller * 1e6 << " us, binarnie " << binarnie * 1e6 << " us";
+        }
+        cout << endl;
+    }
+}
+#endif
+
+#ifdef WIELOMIAN_TESTY
+/**
+ * Samosprawdzające się testy (kompilacja: g++ -O2 -std=c++20 -DWIELOMIAN_TESTY Zad1.cpp). Każdy test porównuje szybki
+ * algorytm z prostym wzorcem: mnożenie szkolne, __int128, zwykły Euclides, mnożenie i dodawanie po kolei.
+ * Program zwraca 0, gdy wszystkie sprawdzenia przeszły.
+ */
+namespace testy {
+    inline size_t bledy = 0;
+
+    void sprawdz(bool warunek, const string& opis) {
+        if (!warunek) {
+            ++bledy;
+            cerr << "BLAD: " << opis << endl;
+        }
+    }
 
-            pierwsze = false;
+    /**
+     * Deterministyczny generator splitmix64, żeby testy dawały te same dane na każdej maszynie.
+     */
+    struct Losowe {
+        uint64_t stan;
+
+        uint64_t operator()() {
+            uint64_t z = (stan += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
         }
 
-        return pierwsze ? "W(x) = 0" : oss.str();
+        long long calkowita(long long zakres) { return (long long)((*this)() % uint64_t(2 * zakres + 1)) - zakres; }
+        double rzeczywista() { return double((*this)() >> 11) * 0x1p-53 * 2 - 1; }
+    };
+
+    template <class T>
+    vector<T> szkolnie(const vector<T>& a, const vector<T>& b) {
+        vector<T> w(a.size() + b.size() - 1, T(0));
+        detail::mnozNaiwnie(a.data(), a.size(), b.data(), b.size(), w.data());
+        return w;
+    }
+
+    template <class T>
+    double roznica(const vector<T>& a, const vector<T>& b) {
+        if (a.size() != b.size()) return numeric_limits<double>::infinity();
+        double m = 0;
+        for (size_t i = 0; i < a.size(); ++i) m = max(m, double(abs(a[i] - b[i])));
+        return m;
     }
 
     /**
-     * Zwraca wartość wielomianu dla danego x.
+     * FFT, Karatsuba i NTT (bezpośrednio i przez detail::mnoz) wokół progów przełączania.
      */
-    double operator()(double x) const {
-        double wynik = 0;
-        for (int i = wsp.size() - 1; i >= 0; --i)     // Algorytm Hornera (ChatGPT)
-            wynik = wynik * x + wsp[i];
-        return wynik;
+    void testMnozenia() {
+        ProgiMnozenia::kalibrujRaz();   // progi wokół których testujemy mają być tymi, których użyje mnoz
+        Losowe los{ 1 };
+        vector<size_t> dlugosci;
+        for (size_t prog : { ProgiMnozenia::karatsuba.load(), ProgiMnozenia::fft.load(), ProgiMnozenia::ntt.load() })
+            for (size_t n : { prog - 1, prog, prog + 1, 2 * prog + 3 }) dlugosci.push_back(n);
+
+        using F = LiczbaModulo<998244353>;
+        for (size_t n : dlugosci) {
+            size_t m = n + los() % 17;
+            string rozmiar = " (n = " + to_string(n) + ", m = " + to_string(m) + ")";
+
+            vector<double> a(n), b(m);
+            for (double& c : a) c = los.rzeczywista();
+            for (double& c : b) c = los.rzeczywista();
+            vector<double> wzor = szkolnie(a, b);
+            double tolerancja = 1e-13 * double(n + m);
+            sprawdz(roznica(detail::mnoz(a.data(), n, b.data(), m), wzor) <= tolerancja, "mnoz double" + rozmiar);
+            sprawdz(roznica(detail::mnozFFT(a.data(), n, b.data(), m), wzor) <= tolerancja, "FFT" + rozmiar);
+            sprawdz(roznica(detail::mnozKaratsuba(a.data(), n, b.data(), m, 8), wzor) <= tolerancja, "Karatsuba" + rozmiar);
+
+            vector<complex<double>> za(n), zb(m);
+            for (auto& c : za) c = { los.rzeczywista(), los.rzeczywista() };
+            for (auto& c : zb) c = { los.rzeczywista(), los.rzeczywista() };
+            sprawdz(roznica(detail::mnoz(za.data(), n, zb.data(), m), szkolnie(za, zb)) <= 2 * tolerancja, "mnoz complex" + rozmiar);
+
+            vector<F> fa(n), fb(m);
+            for (F& c : fa) c = F((long long)(los() % F::modul));
+            for (F& c : fb) c = F((long long)(los() % F::modul));
+            vector<F> wzorF = szkolnie(fa, fb);
+            sprawdz(detail::mnozNTT(fa.data(), n, fb.data(), m) == wzorF, "NTT" + rozmiar);
+            sprawdz(detail::mnoz(fa.data(), n, fb.data(), m) == wzorF, "mnoz GF(p)" + rozmiar);
+            sprawdz(detail::mnozKaratsuba(fa.data(), n, fb.data(), m, 8) == wzorF, "Karatsuba GF(p)" + rozmiar);
+        }
     }
 
     /**
-     * Operator dodawania dwóch wielomianów.
+     * Iloczyny całkowite przez CRT/Garnera dla 1-4 modułów wobec iloczynu liczonego w __int128.
      */
-    Wielomian operator+(const Wielomian& o) const {
-        size_t n = max(wsp.size(), o.wsp.size());
-        vector<double> wynik(n, 0);
-        for (size_t i = 0; i < wsp.size(); ++i) wynik[i] += wsp[i];
-        for (size_t i = 0; i < o.wsp.size(); ++i) wynik[i] += o.wsp[i];
-        return Wielomian(wynik);
+    void testCRT() {
+        Losowe los{ 2 };
+        for (int bity : { 10, 30, 40, 50 }) {
+            for (size_t n : { size_t(1), size_t(70), size_t(300) }) {
+                vector<long long> a(n), b(n + 5);
+                for (long long& c : a) c = los.calkowita(1ll << bity);
+                for (long long& c : b) c = los.calkowita(1ll << bity);
+                vector<__int128> wzor(a.size() + b.size() - 1, 0), wynik;
+                for (size_t i = 0; i < a.size(); ++i)
+                    for (size_t j = 0; j < b.size(); ++j) wzor[i + j] += __int128(a[i]) * b[j];
+                bool policzone = detail::mnozCalkowite(a.data(), a.size(), b.data(), b.size(), wynik);
+                sprawdz(policzone && wynik == wzor, "CRT, " + to_string(bity) + " bitow, n = " + to_string(n));
+            }
+        }
+        vector<long long> duze(300, (1ll << 62) - 1);
+        vector<__int128> wynik;
+        sprawdz(!detail::mnozCalkowite(duze.data(), duze.size(), duze.data(), duze.size(), wynik), "CRT poza zakresem modulow");
     }
 
     /**
-     * Operator odejmowania dwóch wielomianów.
+     * NWD nad GF(p) przez pół-NWD (z obniżonymi progami) wobec zwykłego algorytmu Euklidesa.
      */
-    Wielomian operator-(const Wielomian& o) const {
-        size_t n = max(wsp.size(), o.wsp.size());
-        vector<double> wynik(n, 0);
-        for (size_t i = 0; i < wsp.size(); ++i) wynik[i] += wsp[i];
-        for (size_t i = 0; i < o.wsp.size(); ++i) wynik[i] -= o.wsp[i];
-        return Wielomian(wynik);
+    void testPolNwd() {
+        using F = LiczbaModulo<998244353>;
+        Losowe los{ 3 };
+        auto losowy = [&](size_t n) {
+            vector<F> p(n + 1);
+            for (F& c : p) c = F((long long)(los() % F::modul));
+            if (p.back() == F(0)) p.back() = F(1);
+            return p;
+        };
+        auto euklides = [](vector<F> a, vector<F> b) {
+            detail::przytnijZera(a);
+            detail::przytnijZera(b);
+            while (!b.empty()) {
+                detail::IlorazIReszta<F> qr = detail::dzielDokladnie(a, b);
+                a = move(b);
+                b = move(qr.reszta);
+            }
+            F odwrotnosc = F(1) / a.back();
+            for (F& c : a) c = c * odwrotnosc;
+            return a;
+        };
+
+        size_t staryNwd = detail::progNwd, staryPolNwd = detail::progPolNwd;
+        detail::progNwd = 1;
+        detail::progPolNwd = 16;
+        for (size_t stopien : { 0, 5, 40 }) {
+            for (size_t n : { 50, 300, 700 }) {
+                vector<F> g = losowy(stopien);
+                vector<F> a = detail::iloczynDokladny(g, losowy(n)), b = detail::iloczynDokladny(g, losowy(n - 7));
+                sprawdz(detail::nwdDokladny(a, b) == euklides(a, b),
+                        "pol-NWD, stopien NWD " + to_string(stopien) + ", n = " + to_string(n));
+                sprawdz(WielomianModulo<F::modul>::nwd(a, b) == WielomianModulo<F::modul>(euklides(a, b)),
+                        "WielomianModulo::nwd, stopien NWD " + to_string(stopien) + ", n = " + to_string(n));
+            }
+        }
+        detail::progNwd = staryNwd;
+        detail::progPolNwd = staryPolNwd;
+
+        WielomianModulo<7> w{ -1, 0, 1 };
+        sprawdz(w.toString() == "W(x) = x^2 + 0x + 6" && (w * w).toString() == "W(x) = x^4 + 0x^3 + 5x^2 + 0x + 1", "WielomianModulo::toString");
+        WielomianModulo<7> odczytany{ 0 };
+        sprawdz(!WielomianModulo<7>::parsuj("x^2 - 1", odczytany) && odczytany == w, "WielomianModulo::parsuj");
     }
 
     /**
-     * Operator mnożenia dwóch wielomianów.
+     * Wielomian::nwd odnajduje wspólny czynnik zaszyty w losowych wielomianach; powyżej progu — ścieżka Euklidesa.
      */
-    Wielomian operator*(const Wielomian& o) const {
-        vector<double> wynik(wsp.size() + o.wsp.size() - 1, 0);
-        for (size_t i = 0; i < wsp.size(); ++i)
-            for (size_t j = 0; j < o.wsp.size(); ++j)
-                wynik[i + j] += wsp[i] * o.wsp[j];
-        return Wielomian(wynik);
+    void testNwdPrzyblizonego() {
+        Losowe los{ 7 };
+        auto losowy = [&](size_t n) {
+            vector<double> p(n + 1);
+            for (double& c : p) c = los.rzeczywista();
+            return Wielomian(p);
+        };
+        for (auto [n, m, stopien] : { array<size_t, 3>{ 20, 20, 3 }, array<size_t, 3>{ 80, 80, 3 }, array<size_t, 3>{ 200, 150, 29 } }) {
+            Wielomian g = losowy(stopien);
+            Wielomian nwd = Wielomian::nwd(g * losowy(n - stopien), g * losowy(m - stopien));
+            double blad = nwd.stopien() == int(stopien) ? 0 : numeric_limits<double>::infinity();
+            for (size_t i = 0; i <= stopien; ++i) blad = max(blad, abs(nwd.wspolczynnik(i) - g.wspolczynnik(i) / g.wspolczynnik(stopien)));
+            sprawdz(blad <= 1e-8, "nwd z czynnikiem stopnia " + to_string(stopien) + ", n = " + to_string(n) + ", m = " + to_string(m));
+        }
+
+        size_t prog = detail::progNwdSylvestera;
+        detail::progNwdSylvestera = 0;
+        Wielomian euklides = Wielomian::nwd(Wielomian{ -1, 0, 1 }, Wielomian{ 1, 2, 1 });
+        sprawdz(euklides.stopien() == 1 && abs(euklides.wspolczynnik(0) - 1) <= 1e-12, "nwd algorytmem Euklidesa");
+        detail::progNwdSylvestera = prog;
     }
 
     /**
-     * Operator dodawania i przypisania.
+     * toString -> parsuj odtwarza współczynniki; błędy wskazują właściwe miejsce w tekście.
      */
-    Wielomian& operator+=(const Wielomian& o) { return *this = *this + o; }
+    void testParsowania() {
+        Losowe los{ 4 };
+        for (size_t stopien : { 0, 3, 20, 500 }) {
+            vector<double> c(stopien + 1);
+            for (double& x : c) x = los() % 3 == 0 ? 0.0 : double(los.calkowita(4000)) / 8;   // toString drukuje 6 cyfr znaczących
+            if (c.back() == 0) c.back() = 1;
+            Wielomian w(c), odczytany({ 0 });
+            BladParsowania b = Wielomian::parsuj(w.toString(), odczytany);
+            bool zgodny = !b && odczytany.stopien() == w.stopien();
+            for (size_t i = 0; zgodny && i <= stopien; ++i) zgodny = odczytany.wspolczynnik(i) == c[i];
+            sprawdz(zgodny, "parsuj(toString()), stopien " + to_string(stopien));
+        }
+
+        Wielomian rzadki({ 0 });
+        sprawdz(!Wielomian::parsuj("x^100000 - 2*x^3 + x^3 + 1", rzadki) && rzadki.stopien() == 100000 && rzadki.wspolczynnik(3) == -1,
+                "parsuj wielomianu rzadkiego");
+        sprawdz(!Wielomian::parsuj("x^2147483647 + 1", rzadki) && rzadki.stopien() == numeric_limits<int>::max(),
+                "parsuj najwyzszego dopuszczalnego wykladnika");
+
+        struct Przypadek { const char* tekst; size_t pozycja; const char* opis; };
+        for (const Przypadek& p : {
+                 Przypadek{ "", 0, "Brak wyrazow wielomianu." },
+                 Przypadek{ "W(x) 3x", 5, "Oczekiwano znaku = po W(x)." },
+                 Przypadek{ "3x 2", 3, "Oczekiwano + lub - miedzy wyrazami." },
+                 Przypadek{ "3x + * 2", 5, "Oczekiwano wspolczynnika." },
+                 Przypadek{ "3 * y", 4, "Oczekiwano x po *." },
+                 Przypadek{ "x^a", 2, "Oczekiwano wykladnika." },
+                 Przypadek{ "x^18446744073709551615 + 1", 2, "Wykladnik poza zakresem." },
+                 Przypadek{ "x^99999999999999999999999", 2, "Wykladnik poza zakresem." },
+                 Przypadek{ "3 - x^2147483648", 6, "Wykladnik poza zakresem." } }) {
+            Wielomian w{ 7 };
+            BladParsowania b = Wielomian::parsuj(p.tekst, w);
+            sprawdz(b && b.pozycja == p.pozycja && string_view(b.opis) == p.opis && w.stopien() == 0 && w.wspolczynnik(0) == 7,
+                    string("blad parsowania \"") + p.tekst + "\"");
+        }
+    }
 
     /**
-     * Operator odejmowania i przypisania.
+     * Zapis przez PolynomialStoreWriter i odczyt przez PolynomialStore; odczyt jako inny typ jest odrzucany.
      */
-    Wielomian& operator-=(const Wielomian& o) { return *this = *this - o; }
+    void testMagazynu() {
+        const string sciezka = "wielomiany_test.bin";
+        Losowe los{ 5 };
+        vector<Wielomian> zapisane;
+        for (size_t k = 0; k < 20; ++k) {
+            vector<double> c(1 + k * 7);
+            for (double& x : c) x = los.rzeczywista();
+            c.back() = 1;
+            zapisane.emplace_back(c);
+        }
+        {
+            PolynomialStoreWriter<double> zapis(sciezka);
+            for (const Wielomian& w : zapisane) zapis.dodaj(w);
+            zapis.zamknij();
+        }
+        {
+            PolynomialStore<double> magazyn(sciezka);
+            bool zgodny = magazyn.size() == zapisane.size();
+            for (size_t k = 0; zgodny && k < zapisane.size(); ++k) {
+                WielomianView<double> v = magazyn[k];
+                zgodny = v.stopien() == zapisane[k].stopien();
+                for (int i = 0; zgodny && i <= v.stopien(); ++i) zgodny = v.wspolczynnik(size_t(i)) == zapisane[k].wspolczynnik(size_t(i));
+            }
+            sprawdz(zgodny, "odczyt PolynomialStore");
+        }
+        bool odrzucony = false;
+        try { PolynomialStore<float> zlyTyp(sciezka); }
+        catch (const runtime_error&) { odrzucony = true; }
+        sprawdz(odrzucony, "PolynomialStore o innym typie wspolczynnikow");
+        std::remove(sciezka.c_str());
+    }
 
     /**
-     * Operator mnożenia i przypisania.
+     * productOf i sumOf na jawnych pulach czterech wątków wobec mnożenia i dodawania po kolei.
      */
-    Wielomian& operator*=(const Wielomian& o) { return *this = *this * o; }
-};
+    void testPul() {
+        Losowe los{ 6 };
+        vector<Wielomian> czynniki;
+        for (size_t k = 0; k < 300; ++k) czynniki.push_back(Wielomian{ los.rzeczywista(), 1.0 });
+        Wielomian kolejno{ 1 };
+        for (const Wielomian& c : czynniki) kolejno *= c;
+        detail::PulaZadan pulaZadan(4);
+        Wielomian drzewem = productOf(czynniki, pulaZadan);
+        double skala = 0, blad = 0;
+        for (int i = 0; i <= kolejno.stopien(); ++i) {
+            skala = max(skala, abs(kolejno.wspolczynnik(size_t(i))));
+            blad = max(blad, abs(kolejno.wspolczynnik(size_t(i)) - drzewem.wspolczynnik(size_t(i))));
+        }
+        sprawdz(drzewem.stopien() == kolejno.stopien() && blad <= 1e-9 * skala, "productOf na 4 watkach");
+
+        vector<Wielomian> skladniki;
+        for (size_t k = 0; k < 20000; ++k) {
+            vector<double> c(1 + k % 50);
+            for (double& x : c) x = double(los.calkowita(100));
+            skladniki.emplace_back(c);
+        }
+        Wielomian suma{ 0 };
+        for (const Wielomian& s : skladniki) suma += s;
+        detail::PulaWatkow pulaWatkow(4);
+        Wielomian rownolegle = sumOf(skladniki, pulaWatkow);
+        bool zgodna = rownolegle.stopien() == suma.stopien();
+        for (int i = 0; zgodna && i <= suma.stopien(); ++i) zgodna = rownolegle.wspolczynnik(size_t(i)) == suma.wspolczynnik(size_t(i));
+        sprawdz(zgodna, "sumOf na 4 watkach");
+    }
+
+    /**
+     * Pierwiastek szeregu (sprzężona iteracja z odwrotnością) podniesiony do kwadratu odtwarza szereg,
+     * dla rzędów po obu stronach progów mnożenia; także dla współczynników zespolonych.
+     */
+    void testSzeregu() {
+        Losowe los{ 15 };
+        for (size_t n : { 1, 2, 3, 17, 64, 300, 1500 }) {
+            vector<double> c(n);
+            vector<complex<double>> z(n);
+            for (size_t i = 0; i < n; ++i) {
+                c[i] = los.rzeczywista() / double(i + 1);
+                z[i] = { los.rzeczywista() / double(i + 1), los.rzeczywista() / double(i + 1) };
+            }
+            c[0] = 2;
+            z[0] = { 1, 1 };
+            SzeregPotegowy f(c, n);
+            SzeregPotegowy kwadrat = f.sqrt() * f.sqrt();
+            double blad = 0;
+            for (size_t i = 0; i < n; ++i) blad = max(blad, abs(kwadrat[i] - f[i]));
+            sprawdz(blad <= 1e-9, "sqrt szeregu n=" + to_string(n));
+
+            wielomiany::SzeregPotegowy<complex<double>> g(z, n);
+            auto kwadratZ = g.sqrt() * g.sqrt();
+            blad = 0;
+            for (size_t i = 0; i < n; ++i) blad = max(blad, abs(kwadratZ[i] - g[i]));
+            sprawdz(blad <= 1e-9, "sqrt szeregu complex n=" + to_string(n));
+        }
+    }
+
+    /**
+     * Uruchamia wszystkie testy i zwraca liczbę nieudanych sprawdzeń.
+     */
+    size_t uruchom() {
+        testMnozenia();
+        testCRT();
+        testPolNwd();
+        testNwdPrzyblizonego();
+        testParsowania();
+        testMagazynu();
+        testPul();
+        testSzeregu();
+        cout << (bledy ? "Testy: " + to_string(bledy) + " bledow" : string("Testy: OK")) << endl;
+        return bledy;
+    }
+}
+#endif
 
 /**
  * Funkcja główna — testuje klasę Wielomian.
  * Używa try-catch do obsługi wyjątków.
  */
 int main() {
+#ifdef WIELOMIAN_TESTY
+    return testy::uruchom() == 0 ? 0 : 1;
+#endif
     try {
         Wielomian w1({ 1, 2, 3 });     // 3x^2 + 2x + 1
         Wielomian w2({ -1, 0, 1 });    // x^2 - 1
@@ -133,9 +5366,35 @@ int main() {
         cout << "Roznica:   " << (w1 - w2).toString() << endl;
         cout << "Iloczyn:   " << (w1 * w2).toString() << endl;
         cout << "Wartosc w1(2) = " << w1(2.0) << endl;
+        cout << "Pochodne w1 w 2: ";
+        for (double p : w1.evalWithDerivatives(2.0, 2)) cout << p << " ";
+        cout << endl;
+        cout << "Iloraz:    " << (w1 / w2).toString() << endl;
+        cout << "Reszta:    " << (w1 % w2).toString() << endl;
+        cout << "NWD:       " << Wielomian::nwd(w1, w2).toString() << endl;
+
+        WielomianModulo<998244353> m1{ 1, 2, 3 }, m2{ -1, 0, 1 };
+        cout << "Iloczyn mod p: " << (m1 * m2).toString() << endl;
+        cout << "Pierwiastki w2:";
+        for (const Pierwiastek& p : w2.pierwiastki()) cout << " " << p.wartosc;
+        cout << endl;
 
         w1 += w2;
         cout << "w1 += w2:  " << w1.toString() << endl;
+
+        SzeregPotegowy s(Wielomian({ 0, 1 }), 6);
+        cout << "exp(x):    " << s.exp().toString() << endl;
+
+#ifdef WIELOMIAN_BENCHMARK
+        ProgiMnozenia::kalibruj();
+        benchmarkEwaluacji();
+        benchmarkAlokacji();
+        benchmarkFormatowania();
+        benchmarkParsowania();
+        benchmarkIloczynuWielu();
+        benchmarkSumowania();
+        benchmarkPotegowania();
+#endif
     }
     catch (const exception& e) {
         cerr << "Blad: " << e.what() << endl;